@@ -1,3 +1,8 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <vector>
 
 #include <opencv2/bgsegm.hpp>
@@ -5,6 +10,9 @@
 #include <opencv2/imgproc/imgproc.hpp>
 #include <opencv2/video/background_segm.hpp>
 
+#include "ContourAnalysis.hxx"
+#include "FusedMask.hxx"
+#include "Instrumentation.hxx"
 #include "Window.hxx"
 
 #include "Shapes.hxx"
@@ -60,6 +68,26 @@ namespace Detector
 		std::uint32_t m_canny_threshold1;
 		std::uint32_t m_canny_threshold2;
 
+		// Replace the cvtColor, inRange, Blur and Morphology Chain
+		// With a Single Pass over the Image. Output is Identical
+		// Costs 2 MiB and a One Time Table Build whenever the Colour Bounds Change
+		bool m_fused_processing = false;
+
+		// Once an Object is Found, Search only a Region around it in Later Frames
+		// The Region Extends m_tracking_padding Radii from the Center on Every Side
+		// And a Full Frame Search is Forced at least every m_reacquisition_interval Frames
+		// To Pick Up a Larger Object Appearing Elsewhere
+		bool			  m_tracking					= false;
+		float			  m_tracking_padding		= 2.0f;
+		std::uint32_t m_reacquisition_interval = 30;
+
+		// Used by Detector::detectCircularObjects
+		// Contours Enclosing Less Area, in Pixels, are Rejected before Anything Else is Computed
+		// And Contours Scoring Less are not Reported
+		// See ContourAnalysis for the Score
+		double m_minimum_area  = 25;
+		float	 m_minimum_score = 0.62f;
+
 		// Add Characteristics as and when required
 
 	 public:
@@ -115,23 +143,107 @@ namespace Detector
 		{
 			return m_bckgrnd_sbtrctr_type;
 		}
+
+		Characteristics& setFusedProcessing(const bool p_fused_processing) noexcept
+		{
+			m_fused_processing = p_fused_processing;
+			return *this;
+		}
+		bool isFusedProcessing() const noexcept
+		{
+			return m_fused_processing;
+		}
+
+		// Note that Background Subtractors Model the Whole Frame
+		// So Tracking is Ignored unless the Subtractor is BackGroundSubtractorTypes::NONE
+		Characteristics& setTracking(const bool			 p_tracking,
+											  const float			 p_tracking_padding		  = 2.0f,
+											  const std::uint32_t p_reacquisition_interval = 30) noexcept
+		{
+			m_tracking					= p_tracking;
+			m_tracking_padding		= std::abs(p_tracking_padding);
+			m_reacquisition_interval = p_reacquisition_interval;
+			return *this;
+		}
+		bool isTracking() const noexcept
+		{
+			return m_tracking;
+		}
+		float getTrackingPadding() const noexcept
+		{
+			return m_tracking_padding;
+		}
+		std::uint32_t getReacquisitionInterval() const noexcept
+		{
+			return m_reacquisition_interval;
+		}
+
+		Characteristics& setMinimumArea(const double p_minimum_area) noexcept
+		{
+			m_minimum_area = std::abs(p_minimum_area);
+			return *this;
+		}
+		double getMinimumArea() const noexcept
+		{
+			return m_minimum_area;
+		}
+		Characteristics& setMinimumScore(const float p_minimum_score) noexcept
+		{
+			m_minimum_score = p_minimum_score;
+			return *this;
+		}
+		float getMinimumScore() const noexcept
+		{
+			return m_minimum_score;
+		}
 	};
 
-	struct Detector
+	// InstrumentationPolicy is NoInstrumentation, which Costs Nothing
+	// Or Instrumentation, which Records the Latency of Every Stage and Counts Contours and Frames
+	// Use Detector unless Instrumentation is Wanted
+	template <typename InstrumentationPolicy = NoInstrumentation>
+	struct BasicDetector
 	{
 	 private:
 		Characteristics						 m_obj_detect_properties;
 		cv::Ptr<cv::BackgroundSubtractor> m_bckgrnd_sbtrctr;
+		FusedMask								 m_fused_mask;
+		ContourAnalysis						 m_contour_analysis;
+		InstrumentationPolicy				 m_instrumentation;
+
+		// Scratch Reused from Frame to Frame
+		// Once Warmed Up, the Detector itself does not Allocate
+		// processImage and findCircularObject Never Share a Buffer
+		// So they can Run on Different Threads, as Pipeline does
+		cv::Mat										  m_img_proc;
+		cv::Mat										  m_img_hsv;
+		cv::Mat										  m_img_tmp;
+		cv::Mat										  m_structuring_elem;
+		std::vector<std::vector<cv::Point>> m_contours;
+		std::vector<cv::Point>				  m_approx_curve;
+
+		// Last Object Found while Tracking, Empty if Lost
+		Shape::Circle<> m_tracked{nullptr};
+		std::uint32_t	 m_frames_since_search = 0;
+
+		// Pixels Added Around the Tracking Region, so Tiny Circles still get Context
+		static constexpr int kTrackingMargin = 8;
 
 	 public:
-		Detector(const Characteristics& p_obj_detect_properties) : m_obj_detect_properties{p_obj_detect_properties}
+		BasicDetector(const Characteristics& p_obj_detect_properties) :
+			 m_obj_detect_properties{p_obj_detect_properties},
+			 m_structuring_elem{cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size{3, 3})}
 		{
 			createBackgroundSubtractor();
+			createFusedMask();
 		}
-		inline Detector& setCharacteristics(const Characteristics& p_obj_detect_properties)
+		inline BasicDetector& setCharacteristics(const Characteristics& p_obj_detect_properties)
 		{
 			m_obj_detect_properties = p_obj_detect_properties;
 			createBackgroundSubtractor();
+			createFusedMask();
+			m_tracked				  = nullptr;
+			m_frames_since_search = 0;
 			return *this;
 		}
 
@@ -141,7 +253,7 @@ namespace Detector
 				return false;
 
 			// Note that ProcessImage Function Also Subtracts from Background
-			processImage(p_img);
+			processImage(p_img, m_img_proc);
 
 			return true;
 		}
@@ -155,7 +267,132 @@ namespace Detector
 			// Unnecessary details, we get a real clean image
 			// This clean Image contains exactly the data we need
 
-			auto img_proc = processImage(img_src);
+			if (m_obj_detect_properties.isTracking() && std::empty(m_bckgrnd_sbtrctr))
+				return countFrame(trackCircularObject(img_src));
+
+			if (!processImage(img_src, m_img_proc))
+				return nullptr;
+
+			return findCircularObject(m_img_proc);
+		}
+
+		// Finds up to p_count Circular Objects, Best First, with their Scores
+		// Unlike detectCircularObjectCenters, which Returns the Largest Contour with at least 8 Vertices
+		// These are Ranked by ContourAnalysis, using Characteristics::getMinimumArea and getMinimumScore
+		// Always Searches the Whole Frame, as Tracking Follows a Single Object
+		// Vectors are Reused, so Passing the Same Ones Every Frame Avoids Allocating
+		// Returns the Number Found
+		std::size_t detectCircularObjects(const cv::Mat&					  img_src,
+													 const std::size_t				  p_count,
+													 std::vector<Shape::Circle<>>& p_circles,
+													 std::vector<float>&				  p_scores)
+		{
+			if (!processImage(img_src, m_img_proc))
+			{
+				p_circles.clear();
+				p_scores.clear();
+				return 0;
+			}
+
+			return findCircularObjects(m_img_proc, p_count, p_circles, p_scores);
+		}
+		// Same, without the Scores
+		inline std::vector<Shape::Circle<>> detectCircularObjects(const cv::Mat& img_src, const std::size_t p_count)
+		{
+			std::vector<Shape::Circle<>> circles;
+			std::vector<float>			  scores;
+			detectCircularObjects(img_src, p_count, circles, scores);
+			return circles;
+		}
+
+		// Applies Blurr, inRange dilate and erode to make the image better and more visible
+		// Original Image Assumed to be in BGR Format
+		// Also performs Background Subtraction
+		// Note that this Updates the Background Subtractor State
+		// So Frames must be Supplied in Order
+		inline cv::Mat processImage(const cv::Mat& img_src)
+		{
+			cv::Mat img_out;
+			processImage(img_src, img_out);
+			return img_out; // Empty if Source is Empty
+		}
+		// Same, but Writes into img_out
+		// Whose Buffer is Reused if it Already has the Right Size
+		inline bool processImage(const cv::Mat& img_src, cv::Mat& img_out)
+		{
+			if (std::empty(img_src))
+			{
+				img_out.release();
+				return false;
+			}
+
+			if (!std::empty(m_fused_mask) && img_src.type() == CV_8UC3)
+				timeStage(Stage::FUSED_MASK, [&] { m_fused_mask.apply(img_src, img_out); });
+			else
+				thresholdImage(img_src, img_out);
+
+			// Apply Background Subtraction
+			// if Background Subtractor Initialised
+
+			if (!std::empty(m_bckgrnd_sbtrctr))
+				timeStage(Stage::BACKGROUND_SUBTRACTION, [&] { m_bckgrnd_sbtrctr->apply(img_out, img_out); });
+
+			return true;
+		}
+
+		// Finds the Largest Circular Object in an Image returned by processImage
+		// Note that the Image Supplied is Overwritten with its Edges
+		// Does not touch the Background Subtractor
+		// So can run on a different thread from processImage
+		Shape::Circle<> findCircularObject(cv::Mat& img_proc)
+		{
+			return countFrame(searchContours(img_proc));
+		}
+
+		// Finds up to p_count Circular Objects in an Image returned by processImage
+		// Same Rules as detectCircularObjects, and the Image is Overwritten as by findCircularObject
+		std::size_t findCircularObjects(cv::Mat&							  img_proc,
+												  const std::size_t				  p_count,
+												  std::vector<Shape::Circle<>>& p_circles,
+												  std::vector<float>&				  p_scores)
+		{
+			p_circles.clear();
+			p_scores.clear();
+			if (std::empty(img_proc))
+				return 0;
+
+			findContours(img_proc);
+
+			timeStage(Stage::CONTOUR_ANALYSIS, [&] {
+				count(Counter::CONTOURS_BELOW_SCORE,
+						m_contour_analysis.analyse(m_contours,
+															m_obj_detect_properties.getMinimumArea(),
+															m_obj_detect_properties.getMinimumScore(),
+															p_count,
+															p_circles,
+															p_scores));
+			});
+
+			countFrame(std::empty(p_circles) ? Shape::Circle<>{nullptr} : p_circles.front());
+			return std::size(p_circles);
+		}
+
+		// Latencies and Counters Recorded so Far
+		// Only with the Instrumentation Policy
+		const InstrumentationPolicy& getInstrumentation() const noexcept
+		{
+			return m_instrumentation;
+		}
+		InstrumentationPolicy& getInstrumentation() noexcept
+		{
+			return m_instrumentation;
+		}
+
+	 private:
+		// Body of findCircularObject
+		// Tracking may Search Several Regions of One Frame, so Frames are Counted by the Callers
+		Shape::Circle<> searchContours(cv::Mat& img_proc)
+		{
 			if (std::empty(img_proc))
 				return nullptr;
 
@@ -166,90 +403,222 @@ namespace Detector
 			// std::vector<cv::Vec3f> circle_points;
 			// cv::HoughCircles(img_proc, circle_points, CV_HOUGH_GRADIENT, 2, img_proc.rows/8,90,90);
 
-			cv::Canny(img_proc,
-						 img_proc,
-						 m_obj_detect_properties.getCannyThresholdFirst(),
-						 m_obj_detect_properties.getCannyThresholdSecond());
-
-			std::vector<std::vector<cv::Point>> circle_points;
-			cv::findContours(img_proc, circle_points, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
-
-			// Remove All Elements that are not Circles
-			// This can be done by finding the Approximate Number of Vertices
-			// If the Approximate Number of Vertices are less than, say 8
-			// Than it is not a circle
-			circle_points.erase(std::remove_if(std::begin(circle_points),
-														  std::end(circle_points),
-														  [](const auto& elem) {
-															  std::vector<cv::Point> approx_curve;
-															  cv::approxPolyDP(
-																	elem, approx_curve, 0.01 * cv::arcLength(elem, true), true);
-
-															  // Remove if Elem is Not a Circle or Circular in Shape
-															  // The Size of approx_curve gives the Number of Vertices
-															  return (std::size(approx_curve) < 8);
-														  }),
-									  std::end(circle_points));
-
-			if (std::empty(circle_points))
-				return nullptr;
+			findContours(img_proc);
 
 			// We Shall work under the Assumption that the Largest Circle
 			// Is the Object We want to Detect
-			const auto circle_detected = (*std::max_element(
-				 std::cbegin(circle_points), std::cend(circle_points), [](const auto& p_left, const auto& p_right) {
-					 // Sort in Descending order of area
-					 return cv::contourArea(p_left) < cv::contourArea(p_right);
-				 }));
+			// Contours are Checked in Place, so Nothing is Copied or Erased
+			// And every Area is Computed Only Once
+			const std::vector<cv::Point>* circle_detected = nullptr;
+			double								largest_area	 = 0;
+			std::size_t							rejected			 = 0;
+			timeStage(Stage::CONTOUR_FILTER, [&] {
+				for (const auto& elem : m_contours)
+				{
+					// Remove All Elements that are not Circles
+					// This can be done by finding the Approximate Number of Vertices
+					// If the Approximate Number of Vertices are less than, say 8
+					// Than it is not a circle
+					cv::approxPolyDP(elem, m_approx_curve, 0.01 * cv::arcLength(elem, true), true);
+					if (std::size(m_approx_curve) < 8)
+					{
+						++rejected;
+						continue;
+					}
+
+					// Keep the First of Equally Large Circles
+					const auto area = cv::contourArea(elem);
+					if (circle_detected == nullptr || area > largest_area)
+					{
+						circle_detected = &elem;
+						largest_area	 = area;
+					}
+				}
+			});
+			count(Counter::CONTOURS_REJECTED, rejected);
+
+			if (circle_detected == nullptr)
+				return nullptr;
 
-			return circle_detected;
+			return *circle_detected;
 		}
 
-	 private:
-		// Applies Blurr, inRange dilate and erode to make the image better and more visible
-		// Original Image Assumed to be in BGR Format
-		// Also performs Background Subtraction
-		inline cv::Mat processImage(const cv::Mat& img_src)
+		// Edges, then their Outer Contours into m_contours
+		inline void findContours(cv::Mat& img_proc)
 		{
+			timeStage(Stage::CANNY, [&] {
+				cv::Canny(img_proc,
+							 img_proc,
+							 m_obj_detect_properties.getCannyThresholdFirst(),
+							 m_obj_detect_properties.getCannyThresholdSecond());
+			});
+
+			timeStage(Stage::FIND_CONTOURS,
+						 [&] { cv::findContours(img_proc, m_contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE); });
+			count(Counter::CONTOURS_FOUND, std::size(m_contours));
+		}
 
-			if (std::empty(img_src))
-				return cv::Mat(); // Returns Empty Matrix
+		// Runs p_function, Recording its Latency under p_stage
+		// Without Instrumentation, just Runs it
+		template <typename Function>
+		inline void timeStage(const Stage p_stage, Function&& p_function)
+		{
+			if constexpr (InstrumentationPolicy::kEnabled)
+			{
+				const auto start = std::chrono::steady_clock::now();
+				p_function();
+				m_instrumentation.record(p_stage, std::chrono::steady_clock::now() - start);
+			}
+			else
+				p_function();
+		}
+		inline void count(const Counter p_counter, const std::size_t p_amount = 1) noexcept
+		{
+			if constexpr (InstrumentationPolicy::kEnabled)
+				m_instrumentation.count(p_counter, p_amount);
+		}
+		inline Shape::Circle<> countFrame(const Shape::Circle<>& p_circle) noexcept
+		{
+			count(Counter::FRAMES);
+			if (std::empty(p_circle))
+				count(Counter::FRAMES_WITHOUT_DETECTION);
+			return p_circle;
+		}
 
-			cv::Mat img_out;
+		// Works in the Start of a Frame Sized Buffer, with the Region's Own Step
+		// So Regions of Changing Size do not Reallocate it
+		// Not being a Submatrix, Canny can not Read Edges Left Past the Region by an Earlier Search
+		// Circle is in Region Coordinates
+		inline Shape::Circle<> detectIn(const cv::Mat& img_src, const cv::Rect& p_region)
+		{
+			m_img_proc.create(img_src.size(), CV_8UC1);
 
-			// Source is
-			// https://www.opencv-srf.com/2010/09/object-detection-using-color-seperation.html
+			cv::Mat img_proc{p_region.height, p_region.width, CV_8UC1, m_img_proc.data};
+			if (!processImage(img_src(p_region), img_proc))
+				return nullptr;
 
-			// Convert Original Image to HSV Thresh Image
-			cv::cvtColor(img_src, img_out, cv::ColorConversionCodes::COLOR_BGR2HSV);
+			return searchContours(img_proc);
+		}
+
+		// Searches near the Last Object First
+		// If it is not there, Searches a Region Twice as Large, then the Whole Frame
+		// Note that until the Next Full Search, a Larger Object Elsewhere goes Unnoticed
+		Shape::Circle<> trackCircularObject(const cv::Mat& img_src)
+		{
+			const cv::Rect frame{0, 0, img_src.cols, img_src.rows};
 
-			cv::inRange(img_out,
-							m_obj_detect_properties.getLowerColourBounds(),
-							m_obj_detect_properties.getHigherColourBounds(),
-							img_out);
+			if (!std::empty(m_tracked) && m_frames_since_search < m_obj_detect_properties.getReacquisitionInterval())
+			{
+				auto padding = m_obj_detect_properties.getTrackingPadding();
+				for (int attempt = 0; attempt < 2; ++attempt, padding *= 2)
+				{
+					const auto region = trackingRegion(frame, padding);
+					if (std::empty(region) || region == frame)
+						break;
+
+					auto circle = detectIn(img_src, region);
+					if (!std::empty(circle) && !isCutByRegion(circle, region, frame))
+					{
+						circle.setCenter(circle.getCenterX() + region.x, circle.getCenterY() + region.y);
+						m_tracked = circle;
+						++m_frames_since_search;
+						return circle;
+					}
+				}
+			}
+
+			m_tracked				  = detectIn(img_src, frame);
+			m_frames_since_search = 0;
+			return m_tracked;
+		}
 
-			const cv::Size kSize{3, 3};
+		inline cv::Rect trackingRegion(const cv::Rect& p_frame, const float p_padding) const
+		{
+			const int half = static_cast<int>(std::ceil(m_tracked.getRadius() * p_padding)) + kTrackingMargin;
+			const int x		= static_cast<int>(std::lround(m_tracked.getCenterX()));
+			const int y		= static_cast<int>(std::lround(m_tracked.getCenterY()));
 
-			// blur effect
-			cv::GaussianBlur(img_out, img_out, kSize, 0);
+			return cv::Rect{x - half, y - half, 2 * half + 1, 2 * half + 1} & p_frame;
+		}
 
-			const auto structuring_elem = cv::getStructuringElement(cv::MORPH_ELLIPSE, kSize);
+		// A Circle Running into the Edge of the Region may just be Part of a Larger One
+		// Edges Shared with the Frame do not Count, a Full Search would Cut it there too
+		// Circle is in Region Coordinates
+		static inline bool
+			 isCutByRegion(const Shape::Circle<>& p_circle, const cv::Rect& p_region, const cv::Rect& p_frame) noexcept
+		{
+			const auto radius = p_circle.getRadius();
+
+			return (p_region.x > p_frame.x && p_circle.getCenterX() - radius < 1) ||
+					 (p_region.y > p_frame.y && p_circle.getCenterY() - radius < 1) ||
+					 (p_region.x + p_region.width < p_frame.x + p_frame.width &&
+					  p_circle.getCenterX() + radius > p_region.width - 2) ||
+					 (p_region.y + p_region.height < p_frame.y + p_frame.height &&
+					  p_circle.getCenterY() + radius > p_region.height - 2);
+		}
 
-			// morphological opening (remove small objects from the foreground)
-			cv::erode(img_out, img_out, structuring_elem);
-			cv::dilate(img_out, img_out, structuring_elem);
+		// View of the Top Left p_size of p_buffer
+		// The Buffer only Grows, so once a Full Frame has been Searched
+		// Tracking Regions of Changing Size do not Reallocate it
+		static inline cv::Mat scratch(cv::Mat& p_buffer, const cv::Size& p_size, const int p_type)
+		{
+			if (p_buffer.type() != p_type || p_buffer.cols < p_size.width || p_buffer.rows < p_size.height)
+				p_buffer.create(std::max(p_buffer.rows, p_size.height), std::max(p_buffer.cols, p_size.width), p_type);
 
-			// morphological closing (fill small holes in the foreground)
-			cv::dilate(img_out, img_out, structuring_elem);
-			cv::erode(img_out, img_out, structuring_elem);
+			return p_buffer(cv::Rect{0, 0, p_size.width, p_size.height});
+		}
 
-			// Apply Background Subtraction
-			// if Background Subtractor Initialised
+		// The Colour Separation and Morphology Chain
+		// FusedMask Computes the Same in One Pass
+		// Intermediate Results go to Views of Frame Sized Scratch Buffers, so Nothing is Reallocated
+		// Not even for the Tracking Regions
+		inline void thresholdImage(const cv::Mat& img_src, cv::Mat& img_out)
+		{
+			// Source is
+			// https://www.opencv-srf.com/2010/09/object-detection-using-color-seperation.html
 
-			if (!std::empty(m_bckgrnd_sbtrctr))
-				m_bckgrnd_sbtrctr->apply(img_out, img_out);
+			auto img_hsv = scratch(m_img_hsv, img_src.size(), img_src.type());
+			auto img_tmp = scratch(m_img_tmp, img_src.size(), CV_8UC1);
+
+			timeStage(Stage::CVT_COLOR, [&] {
+				// Convert Original Image to HSV Thresh Image
+				cv::cvtColor(img_src, img_hsv, cv::ColorConversionCodes::COLOR_BGR2HSV);
+
+				cv::inRange(img_hsv,
+								m_obj_detect_properties.getLowerColourBounds(),
+								m_obj_detect_properties.getHigherColourBounds(),
+								img_tmp);
+			});
+
+			timeStage(Stage::MORPHOLOGY, [&] {
+				// Scratch Buffers are Views into Larger Ones
+				// Isolated, so the Filters Treat the Edge of the View as the Border
+				// Rather than Reading Stale Pixels Past it
+				// Which also Keeps GaussianBlur on its Bit Exact Path
+				const auto anchor		 = cv::Point{-1, -1};
+				const auto border		 = cv::BORDER_CONSTANT | cv::BORDER_ISOLATED;
+				const auto border_value = cv::morphologyDefaultBorderValue();
+
+				// blur effect
+				cv::GaussianBlur(img_tmp, img_out, m_structuring_elem.size(), 0, 0, cv::BORDER_DEFAULT | cv::BORDER_ISOLATED);
+
+				// morphological opening (remove small objects from the foreground)
+				cv::erode(img_out, img_tmp, m_structuring_elem, anchor, 1, border, border_value);
+				cv::dilate(img_tmp, img_out, m_structuring_elem, anchor, 1, border, border_value);
+
+				// morphological closing (fill small holes in the foreground)
+				cv::dilate(img_out, img_tmp, m_structuring_elem, anchor, 1, border, border_value);
+				cv::erode(img_tmp, img_out, m_structuring_elem, anchor, 1, border, border_value);
+			});
+		}
 
-			return img_out;
+		inline void createFusedMask()
+		{
+			if (m_obj_detect_properties.isFusedProcessing())
+				m_fused_mask.build(m_obj_detect_properties.getLowerColourBounds(),
+										 m_obj_detect_properties.getHigherColourBounds());
+			else
+				m_fused_mask = FusedMask{};
 		}
 
 		// Note that In order to make this more efficient
@@ -285,4 +654,6 @@ namespace Detector
 			}
 		}
 	};
+
+	using Detector = BasicDetector<>;
 } // namespace Detector
\ No newline at end of file
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "Shapes.hxx"
+
+namespace Detector
+{
+	// Area, Perimeter and Circularity of a Closed Contour
+	// Found Together in a Single Pass over its Points
+	struct ContourMeasurement
+	{
+	 private:
+		double m_area		 = 0;
+		double m_perimeter = 0;
+
+	 public:
+		ContourMeasurement(const std::vector<cv::Point>& p_contour) noexcept
+		{
+			const auto count = std::size(p_contour);
+			if (count == 0)
+				return;
+
+			// Shoelace for the Area, the Zeroth Moment
+			// Same as cv::contourArea and cv::arcLength with the Contour Closed
+			double twice_area = 0;
+			auto	 previous	= p_contour[count - 1];
+			for (const auto& point : p_contour)
+			{
+				twice_area += static_cast<double>(previous.x) * point.y - static_cast<double>(point.x) * previous.y;
+				m_perimeter += std::hypot(static_cast<double>(point.x - previous.x), static_cast<double>(point.y - previous.y));
+				previous = point;
+			}
+			m_area = std::abs(twice_area) / 2;
+		}
+
+		double getArea() const noexcept
+		{
+			return m_area;
+		}
+		double getPerimeter() const noexcept
+		{
+			return m_perimeter;
+		}
+		// 4πA/P², 1 for a Perfect Circle
+		// Note that Pixel Contours of Circles Score Around 0.8 to 0.9, and so do Upright Squares
+		double getCircularity() const noexcept
+		{
+			return m_perimeter > 0 ? 4 * CV_PI * m_area / (m_perimeter * m_perimeter) : 0;
+		}
+	};
+
+	// Ranks the Contours found in an Image by how Circular they are
+	// Score is Circularity times the Share of the Enclosing Circle the Contour Fills
+	// Both are 1 for a Disc, while a Square Fills only 2/π of its Circle
+	// So Squares Score Around 0.5 and Pixel Circles Around 0.65 to 0.9
+	// Keeps its Scratch from Call to Call, so once Warmed Up it does not Allocate
+	struct ContourAnalysis
+	{
+	 private:
+		struct Candidate
+		{
+			float				 m_score;
+			double			 m_area;
+			std::size_t		 m_index;
+			Shape::Circle<> m_circle;
+		};
+
+		std::vector<Candidate> m_candidates;
+
+	 public:
+		// Writes the p_count Best Circles into p_circles and their Scores into p_scores, Best First
+		// Equal Scores go to the Larger Contour, then the Earlier One
+		// Contours Smaller than p_minimum_area or Scoring Below p_minimum_score are Rejected
+		// The Cheap Area and Circularity Checks come First, the Enclosing Circle only for Contours that Pass them
+		// Returns the Number of Contours Rejected
+		std::size_t analyse(const std::vector<std::vector<cv::Point>>& p_contours,
+								  const double										 p_minimum_area,
+								  const float										 p_minimum_score,
+								  const std::size_t								 p_count,
+								  std::vector<Shape::Circle<>>&				 p_circles,
+								  std::vector<float>&							 p_scores)
+		{
+			m_candidates.clear();
+			p_circles.clear();
+			p_scores.clear();
+
+			for (std::size_t i = 0; i < std::size(p_contours); ++i)
+			{
+				const ContourMeasurement measurement{p_contours[i]};
+				const auto					 area = measurement.getArea();
+				if (area <= 0 || area < p_minimum_area)
+					continue;
+
+				// The Fill is at most 1, so Circularity Bounds the Score
+				const auto circularity = measurement.getCircularity();
+				if (circularity < p_minimum_score)
+					continue;
+
+				float			radius;
+				cv::Point2f center;
+				cv::minEnclosingCircle(p_contours[i], center, radius);
+
+				const auto fill  = radius > 0 ? std::min(1.0, area / (CV_PI * radius * radius)) : 0.0;
+				const auto score = static_cast<float>(circularity * fill);
+				if (score < p_minimum_score)
+					continue;
+
+				m_candidates.push_back(Candidate{score, area, i, Shape::Circle<>{center, radius}});
+			}
+
+			const auto kept = std::min(p_count, std::size(m_candidates));
+			std::partial_sort(std::begin(m_candidates),
+									std::begin(m_candidates) + kept,
+									std::end(m_candidates),
+									[](const Candidate& p_first, const Candidate& p_second) noexcept {
+										if (p_first.m_score != p_second.m_score)
+											return p_first.m_score > p_second.m_score;
+										if (p_first.m_area != p_second.m_area)
+											return p_first.m_area > p_second.m_area;
+										return p_first.m_index < p_second.m_index;
+									});
+
+			for (std::size_t i = 0; i < kept; ++i)
+			{
+				p_circles.push_back(m_candidates[i].m_circle);
+				p_scores.push_back(m_candidates[i].m_score);
+			}
+
+			return std::size(p_contours) - std::size(m_candidates);
+		}
+	};
+} // namespace Detector
@@ -0,0 +1,312 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/core/utility.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+namespace Detector
+{
+	// One Bit for Every one of the 2^24 BGR Colours
+	// Set if the Colour, Once Converted to HSV, Lies Within the Bounds
+	// Takes 2 MiB and Replaces cvtColor + inRange with a Single Lookup
+	struct ColourTable
+	{
+	 private:
+		std::vector<std::uint8_t> m_bits;
+		cv::Scalar					  m_lower_colour_bound;
+		cv::Scalar					  m_higher_colour_bound;
+
+	 public:
+		// Note provide Limits as HSV
+		// Rebuilding with the Same Bounds is Free
+		void build(const cv::Scalar& p_lower_colour_bound, const cv::Scalar& p_higher_colour_bound)
+		{
+			if (!std::empty(m_bits) && m_lower_colour_bound == p_lower_colour_bound &&
+				 m_higher_colour_bound == p_higher_colour_bound)
+				return;
+
+			m_lower_colour_bound  = p_lower_colour_bound;
+			m_higher_colour_bound = p_higher_colour_bound;
+			m_bits.assign(std::size_t{1} << 21, 0);
+
+			// OpenCV Classifies Every Colour Itself
+			// So the Table Agrees with cvtColor and inRange Bit for Bit
+			// Whatever Rounding the Installed Version Uses
+			// One Blue Value at a Time, Green along the Rows and Red along the Columns
+			cv::Mat bgr{256, 256, CV_8UC3};
+			cv::Mat hsv;
+			cv::Mat in_range;
+			for (int b = 0; b < 256; ++b)
+			{
+				for (int g = 0; g < 256; ++g)
+				{
+					auto* row = bgr.ptr<cv::Vec3b>(g);
+					for (int r = 0; r < 256; ++r)
+						row[r] = cv::Vec3b{static_cast<uchar>(b), static_cast<uchar>(g), static_cast<uchar>(r)};
+				}
+
+				cv::cvtColor(bgr, hsv, cv::ColorConversionCodes::COLOR_BGR2HSV);
+				cv::inRange(hsv, m_lower_colour_bound, m_higher_colour_bound, in_range);
+
+				for (int g = 0; g < 256; ++g)
+				{
+					const auto* row = in_range.ptr<uchar>(g);
+					for (int r = 0; r < 256; ++r)
+						if (row[r] != 0)
+						{
+							const auto index = indexOf(b, g, r);
+							m_bits[index >> 3] |= static_cast<std::uint8_t>(1u << (index & 7));
+						}
+				}
+			}
+		}
+
+		bool empty() const noexcept
+		{
+			return std::empty(m_bits);
+		}
+
+		// Returns 255 if the Colour is in Range, 0 Otherwise
+		// Same as cv::inRange
+		inline uchar lookup(const uchar p_b, const uchar p_g, const uchar p_r) const noexcept
+		{
+			const auto index = indexOf(p_b, p_g, p_r);
+			return static_cast<uchar>(-static_cast<int>((m_bits[index >> 3] >> (index & 7)) & 1));
+		}
+
+	 private:
+		static inline std::uint32_t indexOf(const std::uint32_t p_b, const std::uint32_t p_g, const std::uint32_t p_r) noexcept
+		{
+			return (p_b << 16) | (p_g << 8) | p_r;
+		}
+	};
+
+	// Computes in a Single Pass what Detector::processImage Computes with
+	//		cvtColor -> inRange -> GaussianBlur 3x3 -> erode -> dilate -> dilate -> erode
+	// (3x3 Ellipse, which for this Size is a Cross)
+	// The Frame is Handled in Horizontal Strips Small enough to Stay in Cache
+	// Each Strip runs Through all Stages before the Next one is Loaded
+	// So the Source is Read once and the Mask Written once
+	// Output is Bit Exact with the OpenCV Chain
+	struct FusedMask
+	{
+	 private:
+		// Each Stage Widens the Rows a Strip Needs by 1 on Either Side
+		// 1 for the Blur and 4 for the Morphological Operations
+		static constexpr int kHalo = 5;
+
+		// Bytes of Scratch Targeted per Strip Buffer
+		static constexpr int kStripBytes = 128 * 1024;
+
+		ColourTable m_table;
+
+	 public:
+		void build(const cv::Scalar& p_lower_colour_bound, const cv::Scalar& p_higher_colour_bound)
+		{
+			m_table.build(p_lower_colour_bound, p_higher_colour_bound);
+		}
+
+		bool empty() const noexcept
+		{
+			return std::empty(m_table);
+		}
+
+		// Source must be 8 Bit BGR
+		// Mask is Reallocated only if its Size Changes
+		void apply(const cv::Mat& p_img_src, cv::Mat& p_mask) const
+		{
+			CV_Assert(!std::empty(m_table) && p_img_src.type() == CV_8UC3);
+
+			p_mask.create(p_img_src.size(), CV_8UC1);
+
+			const int rows		  = p_img_src.rows;
+			const int strip_rows = std::max(8, kStripBytes / std::max(p_img_src.cols, 1) - 2 * kHalo);
+			const int strips	  = (rows + strip_rows - 1) / strip_rows;
+
+			cv::parallel_for_(cv::Range{0, strips}, StripBody{*this, p_img_src, p_mask, strip_rows});
+		}
+
+	 private:
+		// A Lambda would be Wrapped in a std::function
+		// Too Large for its Small Buffer, it would Allocate on Every Frame
+		struct StripBody : cv::ParallelLoopBody
+		{
+		 private:
+			const FusedMask& m_fused_mask;
+			const cv::Mat&	  m_img_src;
+			cv::Mat&			  m_mask;
+			const int		  m_strip_rows;
+
+		 public:
+			StripBody(const FusedMask& p_fused_mask, const cv::Mat& p_img_src, cv::Mat& p_mask, const int p_strip_rows) :
+				 m_fused_mask{p_fused_mask}, m_img_src{p_img_src}, m_mask{p_mask}, m_strip_rows{p_strip_rows}
+			{
+			}
+			void operator()(const cv::Range& p_range) const override
+			{
+				for (int strip = p_range.start; strip < p_range.end; ++strip)
+					m_fused_mask.applyStrip(m_img_src,
+													m_mask,
+													strip * m_strip_rows,
+													std::min(m_img_src.rows, (strip + 1) * m_strip_rows));
+			}
+		};
+
+		// Per Thread Scratch
+		// Only ever Grows, so Steady State Frames do not Allocate
+		struct Scratch
+		{
+			std::vector<uchar>			 m_ping;
+			std::vector<uchar>			 m_pong;
+			std::vector<std::uint16_t> m_sums;
+		};
+
+		// Computes Mask Rows [p_first, p_last)
+		void applyStrip(const cv::Mat& p_img_src, cv::Mat& p_mask, const int p_first, const int p_last) const
+		{
+			static thread_local Scratch scratch;
+
+			const int rows = p_img_src.rows;
+			const int cols = p_img_src.cols;
+
+			// Rows Stage p_stage Must Produce
+			// Stage 0 is the Colour Lookup, Stage kHalo the Final erode
+			const auto first = [&](const int p_stage) { return std::max(0, p_first - (kHalo - p_stage)); };
+			const auto last  = [&](const int p_stage) { return std::min(rows, p_last + (kHalo - p_stage)); };
+
+			// Both Buffers are Indexed by Image Row Relative to base
+			const int			base		  = first(0);
+			const std::size_t buffer_size = static_cast<std::size_t>(last(0) - base) * cols;
+			if (std::size(scratch.m_ping) < buffer_size)
+			{
+				scratch.m_ping.resize(buffer_size);
+				scratch.m_pong.resize(buffer_size);
+			}
+			if (std::size(scratch.m_sums) < static_cast<std::size_t>(cols))
+				scratch.m_sums.resize(cols);
+
+			uchar* const ping = scratch.m_ping.data();
+			uchar* const pong = scratch.m_pong.data();
+			const auto	 row  = [&](uchar* p_buffer, const int p_row) { return p_buffer + (p_row - base) * cols; };
+			// Morphology Ignores Neighbours Outside the Image
+			const auto neighbour = [&](uchar* p_buffer, const int p_row) {
+				return (p_row < 0 || p_row >= rows) ? nullptr : row(p_buffer, p_row);
+			};
+
+			for (int y = first(0); y < last(0); ++y)
+				lookupRow(p_img_src.ptr<uchar>(y), row(ping, y), cols);
+
+			// GaussianBlur Reflects at the Border (BORDER_REFLECT_101)
+			for (int y = first(1); y < last(1); ++y)
+				blurRow(row(ping, reflect(y - 1, rows)),
+						  row(ping, y),
+						  row(ping, reflect(y + 1, rows)),
+						  scratch.m_sums.data(),
+						  row(pong, y),
+						  cols);
+
+			// Opening
+			for (int y = first(2); y < last(2); ++y)
+				morphRow<Min>(neighbour(pong, y - 1), row(pong, y), neighbour(pong, y + 1), row(ping, y), cols);
+			for (int y = first(3); y < last(3); ++y)
+				morphRow<Max>(neighbour(ping, y - 1), row(ping, y), neighbour(ping, y + 1), row(pong, y), cols);
+
+			// Closing
+			for (int y = first(4); y < last(4); ++y)
+				morphRow<Max>(neighbour(pong, y - 1), row(pong, y), neighbour(pong, y + 1), row(ping, y), cols);
+			for (int y = p_first; y < p_last; ++y)
+				morphRow<Min>(neighbour(ping, y - 1), row(ping, y), neighbour(ping, y + 1), p_mask.ptr<uchar>(y), cols);
+		}
+
+		// Same as cv::borderInterpolate with BORDER_REFLECT_101
+		static inline int reflect(const int p_index, const int p_length) noexcept
+		{
+			if (p_length == 1)
+				return 0;
+			if (p_index < 0)
+				return -p_index;
+			if (p_index >= p_length)
+				return 2 * p_length - p_index - 2;
+			return p_index;
+		}
+
+		inline void lookupRow(const uchar* p_bgr, uchar* p_out, const int p_cols) const noexcept
+		{
+			for (int x = 0; x < p_cols; ++x, p_bgr += 3)
+				p_out[x] = m_table.lookup(p_bgr[0], p_bgr[1], p_bgr[2]);
+		}
+
+		// 3x3 Gaussian with sigma 0 is [1 2 1] x [1 2 1] / 16
+		// OpenCV Rounds its Fixed Point Result Half Up, which for these Weights
+		// is Exactly (sum + 8) >> 4
+		static inline void blurRow(const uchar*	p_up,
+											const uchar*	p_cur,
+											const uchar*	p_down,
+											std::uint16_t* p_sums,
+											uchar*			p_out,
+											const int		p_cols) noexcept
+		{
+			// Vertical First, so the Horizontal Pass can Read Neighbouring Sums
+			for (int x = 0; x < p_cols; ++x)
+				p_sums[x] = static_cast<std::uint16_t>(p_up[x] + 2 * p_cur[x] + p_down[x]);
+
+			if (p_cols == 1)
+			{
+				p_out[0] = static_cast<uchar>((4 * p_sums[0] + 8) >> 4);
+				return;
+			}
+
+			p_out[0] = static_cast<uchar>((2 * p_sums[1] + 2 * p_sums[0] + 8) >> 4);
+			for (int x = 1; x < p_cols - 1; ++x)
+				p_out[x] = static_cast<uchar>((p_sums[x - 1] + 2 * p_sums[x] + p_sums[x + 1] + 8) >> 4);
+			p_out[p_cols - 1] = static_cast<uchar>((2 * p_sums[p_cols - 2] + 2 * p_sums[p_cols - 1] + 8) >> 4);
+		}
+
+		struct Min
+		{
+			static inline uchar apply(const uchar p_left, const uchar p_right) noexcept
+			{
+				return std::min(p_left, p_right);
+			}
+		};
+		struct Max
+		{
+			static inline uchar apply(const uchar p_left, const uchar p_right) noexcept
+			{
+				return std::max(p_left, p_right);
+			}
+		};
+
+		// erode (Min) or dilate (Max) with a 3x3 Cross
+		// Missing Rows (nullptr) are Outside the Image and Ignored, as with cv::erode and cv::dilate
+		// Loops are Branch Free over Contiguous Rows so that the Compiler Vectorises them
+		template <typename Op>
+		static inline void
+			 morphRow(const uchar* p_up, const uchar* p_cur, const uchar* p_down, uchar* p_out, const int p_cols) noexcept
+		{
+			if (p_up != nullptr && p_down != nullptr)
+				for (int x = 0; x < p_cols; ++x)
+					p_out[x] = Op::apply(Op::apply(p_up[x], p_down[x]), p_cur[x]);
+			else if (p_up != nullptr || p_down != nullptr)
+			{
+				const auto* other = (p_up != nullptr) ? p_up : p_down;
+				for (int x = 0; x < p_cols; ++x)
+					p_out[x] = Op::apply(other[x], p_cur[x]);
+			}
+			else
+				std::copy(p_cur, p_cur + p_cols, p_out);
+
+			if (p_cols == 1)
+				return;
+
+			p_out[0] = Op::apply(p_out[0], p_cur[1]);
+			for (int x = 1; x < p_cols - 1; ++x)
+				p_out[x] = Op::apply(p_out[x], Op::apply(p_cur[x - 1], p_cur[x + 1]));
+			p_out[p_cols - 1] = Op::apply(p_out[p_cols - 1], p_cur[p_cols - 2]);
+		}
+	};
+} // namespace Detector
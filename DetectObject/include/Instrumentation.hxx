@@ -0,0 +1,276 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <ostream>
+#include <string>
+
+namespace Detector
+{
+	// Stages of a Frame whose Latency is Recorded
+	enum class Stage
+	{
+		// cvtColor to HSV and inRange
+		CVT_COLOR,
+		// GaussianBlur, Opening and Closing
+		MORPHOLOGY,
+		// All of the Above in a Single Pass
+		// Only with Characteristics::setFusedProcessing
+		FUSED_MASK,
+		BACKGROUND_SUBTRACTION,
+		CANNY,
+		FIND_CONTOURS,
+		// approxPolyDP and Area of Every Contour
+		CONTOUR_FILTER,
+		// ContourAnalysis, for Detector::detectCircularObjects
+		CONTOUR_ANALYSIS,
+		// Keep Last
+		COUNT
+	};
+
+	enum class Counter
+	{
+		// Frames Searched for an Object
+		FRAMES,
+		FRAMES_WITHOUT_DETECTION,
+		CONTOURS_FOUND,
+		// Contours with Fewer than 8 Vertices
+		CONTOURS_REJECTED,
+		// Contours Turned Down by ContourAnalysis, for Detector::detectCircularObjects
+		// Too Small, or Scoring Below the Minimum
+		CONTOURS_BELOW_SCORE,
+		// Keep Last
+		COUNT
+	};
+
+	constexpr std::size_t kStageCount	= static_cast<std::size_t>(Stage::COUNT);
+	constexpr std::size_t kCounterCount = static_cast<std::size_t>(Counter::COUNT);
+
+	// Upper Bounds of the Latency Histogram Buckets, in Microseconds
+	// One Last Bucket Holds Everything Slower
+	constexpr std::array<std::uint32_t, 13> kLatencyBounds{
+		 10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000};
+	constexpr std::size_t kLatencyBucketCount = std::size(kLatencyBounds) + 1;
+
+	inline const char* toString(const Stage p_stage) noexcept
+	{
+		switch (p_stage)
+		{
+			case Stage::CVT_COLOR:
+				return "cvt_color";
+			case Stage::MORPHOLOGY:
+				return "morphology";
+			case Stage::FUSED_MASK:
+				return "fused_mask";
+			case Stage::BACKGROUND_SUBTRACTION:
+				return "background_subtraction";
+			case Stage::CANNY:
+				return "canny";
+			case Stage::FIND_CONTOURS:
+				return "find_contours";
+			case Stage::CONTOUR_FILTER:
+				return "contour_filter";
+			case Stage::CONTOUR_ANALYSIS:
+				return "contour_analysis";
+			case Stage::COUNT:
+				break;
+		}
+		return "unknown";
+	}
+
+	// Copy of the Instrumentation at One Point in Time
+	struct InstrumentationSnapshot
+	{
+	 private:
+		friend struct Instrumentation;
+
+		std::array<std::uint64_t, kStageCount>													 m_calls{};
+		std::array<std::uint64_t, kStageCount>													 m_nanoseconds{};
+		std::array<std::array<std::uint64_t, kLatencyBucketCount>, kStageCount> m_buckets{};
+		std::array<std::uint64_t, kCounterCount>												 m_counters{};
+
+	 public:
+		std::uint64_t getCalls(const Stage p_stage) const noexcept
+		{
+			return m_calls[static_cast<std::size_t>(p_stage)];
+		}
+		std::chrono::nanoseconds getTotalLatency(const Stage p_stage) const noexcept
+		{
+			return std::chrono::nanoseconds{m_nanoseconds[static_cast<std::size_t>(p_stage)]};
+		}
+		// Calls in Bucket p_bucket alone, not Cumulative
+		// Bucket i Holds Calls up to kLatencyBounds[i], the Last One the Rest
+		std::uint64_t getBucket(const Stage p_stage, const std::size_t p_bucket) const noexcept
+		{
+			return m_buckets[static_cast<std::size_t>(p_stage)][p_bucket];
+		}
+		std::uint64_t getCounter(const Counter p_counter) const noexcept
+		{
+			return m_counters[static_cast<std::size_t>(p_counter)];
+		}
+	};
+
+	// Instrumentation Policies for Detector::BasicDetector
+
+	// Default Policy
+	// Records Nothing, and every Call to it Compiles Away
+	struct NoInstrumentation
+	{
+		static constexpr bool kEnabled = false;
+	};
+
+	// Records Latency per Stage and the Counters
+	// Each Stage and Counter has a Single Writer, the Thread Running that Part of the Detector
+	// So Writes are Plain Relaxed Stores, no Locked Instructions
+	// Snapshots can be Taken from Any Thread while the Detector Runs
+	struct Instrumentation
+	{
+		static constexpr bool kEnabled = true;
+
+	 private:
+		struct alignas(64) StageData
+		{
+			std::atomic<std::uint64_t>										 m_calls{0};
+			std::atomic<std::uint64_t>										 m_nanoseconds{0};
+			std::array<std::atomic<std::uint64_t>, kLatencyBucketCount> m_buckets{};
+		};
+
+		std::array<StageData, kStageCount>							  m_stages;
+		std::array<std::atomic<std::uint64_t>, kCounterCount> m_counters{};
+
+		static inline void add(std::atomic<std::uint64_t>& p_value, const std::uint64_t p_amount) noexcept
+		{
+			p_value.store(p_value.load(std::memory_order_relaxed) + p_amount, std::memory_order_relaxed);
+		}
+
+	 public:
+		Instrumentation() = default;
+		Instrumentation(const Instrumentation&) = delete;
+		Instrumentation& operator=(const Instrumentation&) = delete;
+
+		void record(const Stage p_stage, const std::chrono::nanoseconds p_latency) noexcept
+		{
+			auto&		  stage		 = m_stages[static_cast<std::size_t>(p_stage)];
+			const auto nanoseconds = static_cast<std::uint64_t>(std::max<std::int64_t>(p_latency.count(), 0));
+
+			std::size_t bucket = 0;
+			while (bucket < std::size(kLatencyBounds) && nanoseconds > kLatencyBounds[bucket] * 1000ull)
+				++bucket;
+
+			add(stage.m_calls, 1);
+			add(stage.m_nanoseconds, nanoseconds);
+			add(stage.m_buckets[bucket], 1);
+		}
+		void count(const Counter p_counter, const std::uint64_t p_amount = 1) noexcept
+		{
+			add(m_counters[static_cast<std::size_t>(p_counter)], p_amount);
+		}
+
+		// Stages are Copied One Field at a Time, so a Snapshot Taken Mid Frame
+		// May Count a Call in One Field and not Yet in Another
+		InstrumentationSnapshot snapshot() const noexcept
+		{
+			InstrumentationSnapshot snapshot;
+			for (std::size_t i = 0; i < kStageCount; ++i)
+			{
+				snapshot.m_calls[i]		  = m_stages[i].m_calls.load(std::memory_order_relaxed);
+				snapshot.m_nanoseconds[i] = m_stages[i].m_nanoseconds.load(std::memory_order_relaxed);
+				for (std::size_t j = 0; j < kLatencyBucketCount; ++j)
+					snapshot.m_buckets[i][j] = m_stages[i].m_buckets[j].load(std::memory_order_relaxed);
+			}
+			for (std::size_t i = 0; i < kCounterCount; ++i)
+				snapshot.m_counters[i] = m_counters[i].load(std::memory_order_relaxed);
+			return snapshot;
+		}
+
+		// Only while the Detector is Idle, else Concurrent Writes may be Lost
+		void reset() noexcept
+		{
+			for (auto& stage : m_stages)
+			{
+				stage.m_calls.store(0, std::memory_order_relaxed);
+				stage.m_nanoseconds.store(0, std::memory_order_relaxed);
+				for (auto& bucket : stage.m_buckets)
+					bucket.store(0, std::memory_order_relaxed);
+			}
+			for (auto& counter : m_counters)
+				counter.store(0, std::memory_order_relaxed);
+		}
+	};
+
+	// Prometheus Text Exposition Format
+	// Latencies as the Histogram <p_prefix>_stage_duration_seconds, One Series per Stage
+	// Counters as <p_prefix>_<name>_total
+	inline void writePrometheus(std::ostream&						 p_out,
+										 const InstrumentationSnapshot& p_snapshot,
+										 const std::string&				 p_prefix = "detector")
+	{
+		const auto histogram = p_prefix + "_stage_duration_seconds";
+		const auto precision = p_out.precision(9);
+
+		p_out << "# HELP " << histogram << " Latency of each detector stage.\n";
+		p_out << "# TYPE " << histogram << " histogram\n";
+		for (std::size_t i = 0; i < kStageCount; ++i)
+		{
+			const auto	stage = static_cast<Stage>(i);
+			const auto* name	= toString(stage);
+
+			std::uint64_t cumulative = 0;
+			for (std::size_t j = 0; j < std::size(kLatencyBounds); ++j)
+			{
+				cumulative += p_snapshot.getBucket(stage, j);
+				p_out << histogram << "_bucket{stage=\"" << name << "\",le=\"" << kLatencyBounds[j] / 1e6 << "\"} "
+						<< cumulative << '\n';
+			}
+			// Counted from the Buckets, so the Series Stays Consistent even in a Snapshot Taken Mid Frame
+			cumulative += p_snapshot.getBucket(stage, std::size(kLatencyBounds));
+			p_out << histogram << "_bucket{stage=\"" << name << "\",le=\"+Inf\"} " << cumulative << '\n';
+			p_out << histogram << "_sum{stage=\"" << name << "\"} " << p_snapshot.getTotalLatency(stage).count() / 1e9
+					<< '\n';
+			p_out << histogram << "_count{stage=\"" << name << "\"} " << cumulative << '\n';
+		}
+
+		const struct
+		{
+			Counter		counter;
+			const char* name;
+			const char* help;
+		} counters[] = {
+			 {Counter::FRAMES, "frames", "Frames searched for an object."},
+			 {Counter::FRAMES_WITHOUT_DETECTION, "frames_without_detection", "Frames in which no object was found."},
+			 {Counter::CONTOURS_FOUND, "contours_found", "Contours returned by findContours."},
+			 {Counter::CONTOURS_REJECTED, "contours_rejected", "Contours with fewer than 8 vertices."},
+			 {Counter::CONTOURS_BELOW_SCORE, "contours_below_score", "Contours too small or not circular enough to rank."},
+		};
+		for (const auto& counter : counters)
+		{
+			const auto metric = p_prefix + "_" + counter.name + "_total";
+			p_out << "# HELP " << metric << ' ' << counter.help << '\n';
+			p_out << "# TYPE " << metric << " counter\n";
+			p_out << metric << ' ' << p_snapshot.getCounter(counter.counter) << '\n';
+		}
+
+		p_out.precision(precision);
+	}
+
+	// Writes to a Temporary File then Renames it
+	// So a Collector Reading the File, such as the node_exporter Textfile Collector, never Sees it Half Written
+	inline bool writePrometheusFile(const std::string&				  p_path,
+											  const InstrumentationSnapshot& p_snapshot,
+											  const std::string&				  p_prefix = "detector")
+	{
+		const auto temporary = p_path + ".tmp";
+		{
+			std::ofstream file{temporary, std::ios::trunc};
+			writePrometheus(file, p_snapshot, p_prefix);
+			if (!file.flush())
+				return false;
+		}
+		return std::rename(temporary.c_str(), p_path.c_str()) == 0;
+	}
+} // namespace Detector
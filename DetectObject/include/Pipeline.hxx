@@ -0,0 +1,303 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <thread>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/videoio.hpp>
+
+#include "CircularObjectDetector.hxx"
+#include "RingBuffer.hxx"
+#include "Shapes.hxx"
+#include "Threads.hxx"
+
+namespace Detector
+{
+	// A Single Frame Travelling Through the Pipeline
+	// Frames are Pooled and Reused, so the Mats keep their Buffers
+	// Across Iterations and cv::VideoCapture decodes Straight into them
+	struct Frame
+	{
+	 private:
+		std::uint64_t	m_index = 0;
+		cv::Mat			m_image;
+		cv::Mat			m_mask;
+		Shape::Circle<> m_circle{nullptr};
+
+		template <typename>
+		friend struct BasicPipeline;
+
+	 public:
+		// Position of the Frame in the Source Video
+		std::uint64_t getIndex() const noexcept
+		{
+			return m_index;
+		}
+		// Image as Decoded from the Source
+		const cv::Mat& getImage() const noexcept
+		{
+			return m_image;
+		}
+		Shape::Circle<> getCircle() const noexcept
+		{
+			return m_circle;
+		}
+	};
+
+	// Snapshot of the Number of Frames Waiting in Front of Each Stage
+	struct QueueDepths
+	{
+		std::size_t decoded	= 0;
+		std::size_t processed = 0;
+		std::size_t analysed	= 0;
+	};
+
+	// Runs Detector::detectCircularObjectCenters as a Staged Pipeline
+	//		Read -> processImage -> findCircularObject -> Sink
+	// Each Stage Runs on its Own Thread, the Sink on the Calling Thread
+	// So that UI::Window can still be Used from it
+	// Every Stage Handles Frames Strictly in Order
+	// Hence with BackPressurePolicy::BLOCK the Results are Exactly those of the Serial Loop
+	// With BackPressurePolicy::DROP_OLDEST Frames are only ever Dropped before processImage
+	// So the Background Subtractor sees a Gap Free Sequence of the Frames that Survive
+	// Idle Stages Spin Briefly then Sleep, so a Slow Sink or Source does not Keep Cores Busy
+	// Takes a Detector with the Same InstrumentationPolicy, see BasicDetector
+	// processImage and findCircularObject Record Different Stages, so Each has a Single Writer
+	template <typename InstrumentationPolicy = NoInstrumentation>
+	struct BasicPipeline
+	{
+		using Sink = std::function<void(const Frame&)>;
+
+	 private:
+		BasicDetector<InstrumentationPolicy>& m_detector;
+		BackPressurePolicy						  m_policy;
+
+		const std::size_t			m_pool_size;
+		std::unique_ptr<Frame[]> m_pool;
+
+		// Shared by Every Queue, and Notified on Stop
+		// So a Stage Waiting on Several Conditions Wakes for Any of them
+		Signal m_signal;
+
+		// Free Frames go from the Sink back to Decode
+		RingBuffer<Frame*> m_free;
+		RingBuffer<Frame*> m_decoded;
+		RingBuffer<Frame*> m_processed;
+		RingBuffer<Frame*> m_analysed;
+
+		std::atomic<std::uint64_t> m_dropped{0};
+		std::atomic<bool>				m_stop{false};
+
+	 public:
+		// Note that the Detector must not be Used Elsewhere while run is Executing
+		BasicPipeline(BasicDetector<InstrumentationPolicy>& p_detector,
+						  const std::size_t							p_queue_capacity = 4,
+						  const BackPressurePolicy					p_policy			  = BackPressurePolicy::BLOCK) :
+			 m_detector{p_detector},
+			 m_policy{p_policy},
+			 // Every Queue can be Full while Each of the 4 Stages Holds a Frame
+			 m_pool_size{3 * std::max<std::size_t>(p_queue_capacity, 1) + 4},
+			 m_pool{new Frame[m_pool_size]},
+			 m_free{m_pool_size, m_signal},
+			 m_decoded{p_queue_capacity, m_signal},
+			 m_processed{p_queue_capacity, m_signal},
+			 m_analysed{p_queue_capacity, m_signal}
+		{
+		}
+		BasicPipeline(const BasicPipeline&) = delete;
+		BasicPipeline& operator=(const BasicPipeline&) = delete;
+
+		// Runs till the Source is Exhausted
+		// Source is Anything with bool read(cv::Mat&), such as cv::VideoCapture
+		// Returns the Number of Frames Delivered to the Sink
+		// Exceptions Thrown by any Stage are Rethrown here
+		template <typename Source>
+		std::uint64_t run(Source& p_source, const Sink& p_sink)
+		{
+			reset();
+
+			std::exception_ptr errors[3];
+			std::uint64_t		 delivered = 0;
+			std::exception_ptr sink_error;
+			{
+				// Stages Already Started are Stopped and Joined if Starting Another Throws
+				Threads stages{[this]() noexcept { requestStop(); }};
+				stages.start([&] { guard(errors[0], m_decoded, [&] { decode(p_source); }); });
+				stages.start([&] { guard(errors[1], m_processed, [&] { process(); }); });
+				stages.start([&] { guard(errors[2], m_analysed, [&] { analyse(); }); });
+
+				try
+				{
+					Frame* frame;
+					while (m_analysed.pop(frame))
+					{
+						p_sink(*frame);
+						++delivered;
+						m_free.push(frame);
+					}
+				}
+				catch (...)
+				{
+					sink_error = std::current_exception();
+					requestStop();
+				}
+			}
+
+			for (const auto& error : errors)
+				if (error)
+					std::rethrow_exception(error);
+			if (sink_error)
+				std::rethrow_exception(sink_error);
+
+			return delivered;
+		}
+
+		QueueDepths getQueueDepths() const noexcept
+		{
+			return {std::size(m_decoded), std::size(m_processed), std::size(m_analysed)};
+		}
+		// Only Non Zero with BackPressurePolicy::DROP_OLDEST
+		std::uint64_t getDroppedFrames() const noexcept
+		{
+			return m_dropped.load(std::memory_order_relaxed);
+		}
+
+	 private:
+		void reset()
+		{
+			// Queues are Closed, and may still Hold Frames, after a Run
+			m_free.reset();
+			m_decoded.reset();
+			m_processed.reset();
+			m_analysed.reset();
+
+			for (std::size_t i = 0; i < m_pool_size; ++i)
+				m_free.tryPush(&m_pool[i]);
+
+			m_dropped.store(0, std::memory_order_relaxed);
+			m_stop.store(false, std::memory_order_relaxed);
+		}
+
+		// Runs a Stage, Always Closing its Output so that Later Stages Finish
+		// On Failure the Whole Pipeline is Asked to Stop
+		template <typename Stage>
+		void guard(std::exception_ptr& p_error, RingBuffer<Frame*>& p_output, Stage p_stage) noexcept
+		{
+			try
+			{
+				p_stage();
+			}
+			catch (...)
+			{
+				p_error = std::current_exception();
+				requestStop();
+			}
+			p_output.close();
+		}
+
+		void requestStop() noexcept
+		{
+			m_stop.store(true, std::memory_order_release);
+			m_signal.notify();
+		}
+		bool stopRequested() const noexcept
+		{
+			return m_stop.load(std::memory_order_acquire);
+		}
+
+		// Blocking Push that Gives Up once a Stop is Requested
+		bool forward(RingBuffer<Frame*>& p_queue, Frame* p_frame)
+		{
+			bool pushed = false;
+			m_signal.waitUntil([&] { return (pushed = p_queue.tryPush(p_frame)) || stopRequested(); });
+			return pushed;
+		}
+
+		// Blocking Pop that Gives Up once a Stop is Requested
+		bool receive(RingBuffer<Frame*>& p_queue, Frame*& p_frame)
+		{
+			bool popped = false;
+			m_signal.waitUntil([&] {
+				if (stopRequested())
+					return true;
+				if (p_queue.tryPop(p_frame))
+					return popped = true;
+				if (!p_queue.isClosed())
+					return false;
+				// Frames Pushed before Closing are Visible by now
+				popped = p_queue.tryPop(p_frame);
+				return true;
+			});
+			return popped;
+		}
+
+		template <typename Source>
+		void decode(Source& p_source)
+		{
+			Frame*		  spare = nullptr;
+			std::uint64_t index = 0;
+			while (!stopRequested())
+			{
+				Frame* frame = spare;
+				spare			 = nullptr;
+
+				// Get Hold of a Free Frame
+				// When Dropping, Steal the Oldest Frame not yet Processed instead of Waiting
+				if (frame == nullptr)
+					m_signal.waitUntil([&] {
+						if (m_free.tryPop(frame))
+							return true;
+						if (m_policy == BackPressurePolicy::DROP_OLDEST && m_decoded.tryPop(frame))
+						{
+							m_dropped.fetch_add(1, std::memory_order_relaxed);
+							return true;
+						}
+						return stopRequested();
+					});
+				if (frame == nullptr)
+					return;
+
+				if (!p_source.read(frame->m_image) || std::empty(frame->m_image))
+					return;
+				frame->m_index = index++;
+
+				if (m_policy == BackPressurePolicy::DROP_OLDEST)
+				{
+					if (m_decoded.pushDropOldest(frame, spare))
+						m_dropped.fetch_add(1, std::memory_order_relaxed);
+				}
+				else if (!forward(m_decoded, frame))
+					return;
+			}
+		}
+
+		void process()
+		{
+			Frame* frame;
+			while (receive(m_decoded, frame))
+			{
+				m_detector.processImage(frame->m_image, frame->m_mask);
+				if (!forward(m_processed, frame))
+					return;
+			}
+		}
+
+		void analyse()
+		{
+			Frame* frame;
+			while (receive(m_processed, frame))
+			{
+				frame->m_circle = m_detector.findCircularObject(frame->m_mask);
+				if (!forward(m_analysed, frame))
+					return;
+			}
+		}
+	};
+
+	using Pipeline = BasicPipeline<>;
+} // namespace Detector
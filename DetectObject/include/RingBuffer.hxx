@@ -0,0 +1,250 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+namespace Detector
+{
+	enum class BackPressurePolicy
+	{
+		// Default Option
+		// Producer Waits till the Consumer Frees a Slot
+		// No Frame is ever Lost
+		BLOCK,
+		// Producer Discards the Oldest Queued Element
+		// To make Space for the Newest One
+		// Keeps Latency Low when Consumer can not Keep Up
+		DROP_OLDEST
+	};
+
+	// Lets Threads Sleep till a Lock Free Structure Changes
+	// Waiters Spin Briefly, then Block on a Condition Variable
+	// Notifiers only Touch the Mutex when Someone is Actually Asleep
+	// So the Lock Free Fast Path Stays Lock Free
+	struct Signal
+	{
+	 private:
+		// Polls before Going to Sleep
+		// Covers the Common Case of a Queue Refilled within Microseconds
+		static constexpr int kSpins = 64;
+
+		std::mutex					m_mutex;
+		std::condition_variable m_condition;
+		std::atomic<std::size_t> m_waiters{0};
+		// Bumped by Every Notification that Found a Waiter
+		std::atomic<std::uint64_t> m_epoch{0};
+
+	 public:
+		// Returns once p_done Returns true
+		// p_done may have Side Effects, such as Trying to Pop, and is Called Repeatedly
+		// It is Called without the Mutex Held, so it may Itself Notify
+		template <typename Predicate>
+		void waitUntil(Predicate p_done)
+		{
+			for (int i = 0; i < kSpins; ++i)
+			{
+				if (p_done())
+					return;
+				std::this_thread::yield();
+			}
+
+			while (true)
+			{
+				m_waiters.fetch_add(1, std::memory_order_relaxed);
+				// Pairs with the Fence in notify
+				// Either p_done Sees the Change, or the Notifier Sees this Waiter and Bumps the Epoch after
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				const auto epoch = m_epoch.load(std::memory_order_acquire);
+				if (p_done())
+				{
+					m_waiters.fetch_sub(1, std::memory_order_relaxed);
+					return;
+				}
+
+				{
+					std::unique_lock<std::mutex> lock{m_mutex};
+					m_condition.wait(lock, [&] { return m_epoch.load(std::memory_order_relaxed) != epoch; });
+				}
+				m_waiters.fetch_sub(1, std::memory_order_relaxed);
+			}
+		}
+
+		// Call after Every Change a Waiter may be Waiting for
+		void notify() noexcept
+		{
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (m_waiters.load(std::memory_order_relaxed) == 0)
+				return;
+
+			{
+				// Under the Mutex, so a Waiter is Either Before its Check or Already Asleep
+				std::lock_guard<std::mutex> lock{m_mutex};
+				m_epoch.fetch_add(1, std::memory_order_release);
+			}
+			m_condition.notify_all();
+		}
+	};
+
+	// Bounded Lock Free Ring Buffer
+	// Meant for a Single Producer and a Single Consumer Thread
+	// The Producer is Also Allowed to Remove the Oldest Element
+	// Which is why the Read Index is Advanced with a Compare Exchange
+	// Elements are Stored as Atomics and must thus be Trivially Copyable
+	// So Queue Pointers to Pooled Objects, not the Objects Themselves
+	template <typename Type, typename = std::enable_if_t<std::is_trivially_copyable_v<Type>>>
+	struct RingBuffer
+	{
+	 private:
+		const std::size_t					m_capacity;
+		std::unique_ptr<std::atomic<Type>[]> m_slots;
+
+		// Indices only ever Increase
+		// Hence the Compare Exchange on m_head can not Suffer from ABA
+		// Kept on Separate Cache Lines to prevent False Sharing
+		alignas(64) std::atomic<std::uint64_t> m_head{0};
+		alignas(64) std::atomic<std::uint64_t> m_tail{0};
+		alignas(64) std::atomic<bool> m_closed{false};
+
+		// Notified on Every Change, Shared when Given to the Constructor
+		std::unique_ptr<Signal> m_own_signal;
+		Signal&						m_signal;
+
+	 public:
+		explicit RingBuffer(const std::size_t p_capacity) :
+			 m_capacity{p_capacity == 0 ? 1 : p_capacity},
+			 m_slots{new std::atomic<Type>[m_capacity]},
+			 m_own_signal{new Signal},
+			 m_signal{*m_own_signal}
+		{
+		}
+		// Several Buffers can Share a Signal
+		// So a Thread can Sleep till Any of them Changes
+		RingBuffer(const std::size_t p_capacity, Signal& p_signal) :
+			 m_capacity{p_capacity == 0 ? 1 : p_capacity}, m_slots{new std::atomic<Type>[m_capacity]}, m_signal{p_signal}
+		{
+		}
+		RingBuffer(const RingBuffer&) = delete;
+		RingBuffer& operator=(const RingBuffer&) = delete;
+
+		// Producer Only
+		// Returns false if the Buffer is Full
+		bool tryPush(const Type p_elem) noexcept
+		{
+			const auto tail = m_tail.load(std::memory_order_relaxed);
+			if (tail - m_head.load(std::memory_order_acquire) >= m_capacity)
+				return false;
+
+			m_slots[tail % m_capacity].store(p_elem, std::memory_order_relaxed);
+			m_tail.store(tail + 1, std::memory_order_release);
+			m_signal.notify();
+			return true;
+		}
+
+		// Producer Only
+		// Waits for a Free Slot, Sleeping if it Takes a While
+		void push(const Type p_elem)
+		{
+			m_signal.waitUntil([&] { return tryPush(p_elem); });
+		}
+
+		// Producer Only
+		// Never Waits. If the Buffer is Full, the Oldest Element is Removed
+		// And Handed back through p_dropped so that it can be Reused
+		// Returns true if an Element had to be Dropped
+		bool pushDropOldest(const Type p_elem, Type& p_dropped) noexcept
+		{
+			bool dropped = false;
+			while (!tryPush(p_elem))
+			{
+				// Consumer may have Emptied a Slot in the Meanwhile
+				// In which case there is Nothing to Drop and we simply Retry
+				if (tryPop(p_dropped))
+					dropped = true;
+			}
+			return dropped;
+		}
+
+		// Consumer. Also Used by the Producer to Drop Elements
+		// Returns false if the Buffer is Empty
+		bool tryPop(Type& p_elem) noexcept
+		{
+			auto head = m_head.load(std::memory_order_relaxed);
+			while (true)
+			{
+				if (head >= m_tail.load(std::memory_order_acquire))
+					return false;
+
+				// The Slot can only be Rewritten once m_head has Moved Past it
+				// In which case the Exchange Below Fails and we Read Again
+				const auto elem = m_slots[head % m_capacity].load(std::memory_order_relaxed);
+				if (m_head.compare_exchange_weak(head, head + 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+				{
+					p_elem = elem;
+					m_signal.notify();
+					return true;
+				}
+			}
+		}
+
+		// Consumer Only
+		// Waits for an Element, Sleeping if it Takes a While
+		// Returns false once the Buffer is Closed and Fully Drained
+		bool pop(Type& p_elem)
+		{
+			bool popped = false;
+			m_signal.waitUntil([&] {
+				if (tryPop(p_elem))
+					return popped = true;
+				if (!m_closed.load(std::memory_order_acquire))
+					return false;
+				// Elements Pushed before Closing are Visible by now
+				popped = tryPop(p_elem);
+				return true;
+			});
+			return popped;
+		}
+
+		// Producer Only
+		// Marks the End of the Stream
+		void close() noexcept
+		{
+			m_closed.store(true, std::memory_order_release);
+			m_signal.notify();
+		}
+		bool isClosed() const noexcept
+		{
+			return m_closed.load(std::memory_order_acquire);
+		}
+
+		// Empties and Reopens the Buffer
+		// Only Call when no Producer or Consumer is Running
+		void reset() noexcept
+		{
+			m_head.store(0, std::memory_order_relaxed);
+			m_tail.store(0, std::memory_order_relaxed);
+			m_closed.store(false, std::memory_order_release);
+		}
+
+		// Approximate when Called while Threads are Running
+		std::size_t size() const noexcept
+		{
+			const auto head = m_head.load(std::memory_order_acquire);
+			const auto tail = m_tail.load(std::memory_order_acquire);
+			return static_cast<std::size_t>(tail > head ? tail - head : 0);
+		}
+		std::size_t capacity() const noexcept
+		{
+			return m_capacity;
+		}
+		bool empty() const noexcept
+		{
+			return size() == 0;
+		}
+	};
+} // namespace Detector
@@ -0,0 +1,457 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/core/utility.hpp>
+#include <opencv2/videoio.hpp>
+
+#include "CircularObjectDetector.hxx"
+#include "RingBuffer.hxx"
+#include "Shapes.hxx"
+#include "Threads.hxx"
+
+namespace Detector
+{
+	// Runs Many Video Streams, each with its Own Detector, on a Fixed Set of Threads
+	// A Few of them Read, the Rest Detect, so the Pool never Runs more Threads than it was Given
+	// Readers Decode a Few Frames Ahead, One Frame per Task, Taking Turns over the Streams
+	// So a Slow or Blocking Source never Holds Up a Detection Thread, only One Reader
+	// A Stream with a Decoded Frame is a Task that Handles that Frame and then Requeues Itself
+	// So a Stream is never on Two Threads at once and its Frames are Handled in Order
+	// Which the Stateful Background Subtractors (MOG, CNT, KNN...) Need
+	// Each Thread Prefers the Streams in its Own Queue, Keeping their State in its Cache
+	// And Steals from the Others only when it Runs Dry
+	// Every Stream gets a BasicDetector with the Given InstrumentationPolicy
+	template <typename InstrumentationPolicy = NoInstrumentation>
+	struct BasicStreamPool
+	{
+		// Called on a Pool Thread
+		// Calls for the Same Stream never Overlap and Arrive in Frame Order
+		// Calls for Different Streams may Run Concurrently
+		using Callback =
+			 std::function<void(std::size_t p_stream_id, std::uint64_t p_frame_index, const Shape::Circle<>& p_circle)>;
+
+	 private:
+		// Frames a Reader can Decode before the Detection Threads Catch Up
+		static constexpr std::size_t kFramesAhead = 3;
+
+		struct Stream
+		{
+			std::function<bool(cv::Mat&)>		  m_read;
+			BasicDetector<InstrumentationPolicy> m_detector;
+			Callback									  m_callback;
+			std::uint64_t							  m_frame_index = 0;
+
+			// Frames go from m_free to a Reader, then through m_decoded to a Detection Thread and back
+			// Either Buffer can Hold Every Frame, so Pushing to them never Waits
+			std::unique_ptr<cv::Mat[]> m_frames{new cv::Mat[kFramesAhead]};
+			RingBuffer<cv::Mat*>		  m_free{kFramesAhead};
+			RingBuffer<cv::Mat*>		  m_decoded{kFramesAhead};
+
+			// Set while the Stream is in a Queue or on a Thread
+			// Whoever Sets it Schedules the Stream, so it is only ever Scheduled Once
+			std::atomic<bool> m_scheduled{false};
+			// The Same for Reading, Stays Set once the Source has Ended
+			std::atomic<bool> m_reading{false};
+			// Queue of the Thread that Last Ran the Stream
+			std::atomic<std::size_t> m_home{0};
+
+			Stream(std::function<bool(cv::Mat&)>&& p_read, const Characteristics& p_properties, Callback&& p_callback) :
+				 m_read{std::move(p_read)}, m_detector{p_properties}, m_callback{std::move(p_callback)}
+			{
+			}
+		};
+
+		// Queue of Stream Indices Owned by One Thread
+		// The Owner Works at the Back, Thieves Take from the Front
+		// Never Holds more than Every Stream, so its Storage is Sized Once
+		struct TaskQueue
+		{
+		 private:
+			std::mutex					 m_mutex;
+			std::vector<std::size_t> m_tasks;
+			std::size_t					 m_head = 0;
+			std::size_t					 m_size = 0;
+
+		 public:
+			void reset(const std::size_t p_capacity)
+			{
+				m_tasks.assign(std::max<std::size_t>(p_capacity, 1), 0);
+				m_head = 0;
+				m_size = 0;
+			}
+			std::size_t pushBack(const std::size_t p_task)
+			{
+				std::lock_guard<std::mutex> lock{m_mutex};
+				m_tasks[(m_head + m_size) % std::size(m_tasks)] = p_task;
+				return ++m_size;
+			}
+			bool popBack(std::size_t& p_task)
+			{
+				std::lock_guard<std::mutex> lock{m_mutex};
+				if (m_size == 0)
+					return false;
+				p_task = m_tasks[(m_head + --m_size) % std::size(m_tasks)];
+				return true;
+			}
+			bool stealFront(std::size_t& p_task)
+			{
+				std::lock_guard<std::mutex> lock{m_mutex};
+				if (m_size == 0)
+					return false;
+				p_task = m_tasks[m_head];
+				m_head = (m_head + 1) % std::size(m_tasks);
+				--m_size;
+				return true;
+			}
+		};
+
+		// Restores OpenCV's Own Threading when run Returns, even by an Exception
+		struct OpenCVThreads
+		{
+		 private:
+			const int m_threads = cv::getNumThreads();
+
+		 public:
+			explicit OpenCVThreads(const int p_threads)
+			{
+				cv::setNumThreads(p_threads);
+			}
+			OpenCVThreads(const OpenCVThreads&) = delete;
+			OpenCVThreads& operator=(const OpenCVThreads&) = delete;
+			~OpenCVThreads()
+			{
+				cv::setNumThreads(m_threads);
+			}
+		};
+
+		std::size_t										 m_thread_count;
+		std::size_t										 m_reader_count;
+		std::vector<std::unique_ptr<Stream>> m_streams;
+		// One per Detection Thread
+		std::unique_ptr<TaskQueue[]> m_queues;
+		// Streams with a Free Frame, Shared by the Readers in Turn
+		TaskQueue m_read_tasks;
+
+		// Streams not yet Exhausted
+		std::atomic<std::size_t> m_active{0};
+		std::atomic<bool>			 m_stop{false};
+
+		// Notified whenever a Stream is Queued, and when the Pool Finishes
+		// Idle Readers and Detection Threads Sleep on it
+		Signal m_signal;
+
+		std::mutex			 m_error_mutex;
+		std::exception_ptr m_error;
+
+	 public:
+		// Defaults to One Thread per Core
+		// A Quarter of them Read, at Least One, unless p_reader_count Says Otherwise
+		// At Least One Thread is Left to Detect, so there are never Fewer than Two
+		explicit BasicStreamPool(const std::size_t p_thread_count = std::thread::hardware_concurrency(),
+										 const std::size_t p_reader_count = 0) :
+			 m_thread_count{std::max<std::size_t>(p_thread_count, 2)},
+			 m_reader_count{
+				  std::clamp<std::size_t>(p_reader_count == 0 ? m_thread_count / 4 : p_reader_count, 1, m_thread_count - 1)},
+			 m_queues{new TaskQueue[getWorkerCount()]}
+		{
+		}
+		BasicStreamPool(const BasicStreamPool&) = delete;
+		BasicStreamPool& operator=(const BasicStreamPool&) = delete;
+
+		// Source is Anything with bool read(cv::Mat&), such as cv::VideoCapture
+		// It is Read by One Reader at a Time, though not Always the Same One
+		// Returns the Id Passed to the Callback
+		// Must not be Called while run is Executing
+		template <typename Source>
+		std::size_t addStream(Source p_source, const Characteristics& p_properties, Callback p_callback)
+		{
+			// Shared, as std::function must be Copyable and cv::VideoCapture is not
+			auto source = std::make_shared<Source>(std::move(p_source));
+			m_streams.push_back(std::make_unique<Stream>(
+				 [source](cv::Mat& p_frame) { return source->read(p_frame); }, p_properties, std::move(p_callback)));
+			return std::size(m_streams) - 1;
+		}
+
+		std::size_t getStreamCount() const noexcept
+		{
+			return std::size(m_streams);
+		}
+		// Readers and Detection Threads Together
+		std::size_t getThreadCount() const noexcept
+		{
+			return m_thread_count;
+		}
+		std::size_t getReaderCount() const noexcept
+		{
+			return m_reader_count;
+		}
+		std::size_t getWorkerCount() const noexcept
+		{
+			return m_thread_count - m_reader_count;
+		}
+		// For its Instrumentation, whose Snapshots can be Taken while run Executes
+		const BasicDetector<InstrumentationPolicy>& getDetector(const std::size_t p_stream_id) const noexcept
+		{
+			return m_streams[p_stream_id]->m_detector;
+		}
+
+		// Runs till Every Stream is Exhausted
+		// OpenCV's Own Threading is Switched Off Meanwhile, Process Wide
+		// Since the Pool Already Keeps Every Core Busy, it would only Oversubscribe them
+		// The First Exception Thrown by a Stream Stops the Pool and is Rethrown here
+		// Note that a Reader Blocked Inside its Source is Waited for
+		void run()
+		{
+			if (std::empty(m_streams))
+				return;
+
+			const auto workers = getWorkerCount();
+			for (std::size_t i = 0; i < workers; ++i)
+				m_queues[i].reset(std::size(m_streams));
+			m_read_tasks.reset(std::size(m_streams));
+			for (std::size_t i = 0; i < std::size(m_streams); ++i)
+			{
+				auto& stream = *m_streams[i];
+				stream.m_free.reset();
+				stream.m_decoded.reset();
+				for (std::size_t j = 0; j < kFramesAhead; ++j)
+					stream.m_free.tryPush(&stream.m_frames[j]);
+				stream.m_frame_index = 0;
+				stream.m_scheduled.store(false);
+				// Round Robin, so Every Thread Starts with its Share
+				stream.m_home.store(i % workers);
+				// Every Stream Starts with Free Frames
+				stream.m_reading.store(true);
+				m_read_tasks.pushBack(i);
+			}
+
+			m_active.store(std::size(m_streams));
+			m_stop.store(false);
+			m_error = nullptr;
+
+			{
+				const OpenCVThreads opencv_threads{1};
+
+				// Stops the Pool before Joining if Starting a Thread Throws
+				// So the Join does not Wait for Every Stream to End
+				Threads threads{[this]() noexcept { requestStop(); }};
+				for (std::size_t i = 0; i < m_reader_count; ++i)
+					threads.start([this] { read(); });
+				for (std::size_t i = 0; i < workers; ++i)
+					threads.start([this, i] { work(i); });
+			}
+
+			if (m_error)
+				std::rethrow_exception(m_error);
+		}
+
+	 private:
+		bool finished() const noexcept
+		{
+			return m_active.load(std::memory_order_acquire) == 0 || m_stop.load(std::memory_order_acquire);
+		}
+
+		void requestStop() noexcept
+		{
+			m_stop.store(true, std::memory_order_release);
+			m_signal.notify();
+		}
+
+		void fail() noexcept
+		{
+			{
+				std::lock_guard<std::mutex> lock{m_error_mutex};
+				if (!m_error)
+					m_error = std::current_exception();
+			}
+			requestStop();
+		}
+
+		// Queues a Stream that has a Decoded Frame, or has Ended, unless it is Already Queued or Running
+		void schedule(const std::size_t p_stream)
+		{
+			auto& stream = *m_streams[p_stream];
+			if (stream.m_scheduled.exchange(true, std::memory_order_acq_rel))
+				return;
+
+			m_queues[stream.m_home.load(std::memory_order_relaxed)].pushBack(p_stream);
+			m_signal.notify();
+		}
+
+		// Queues a Stream with a Free Frame for the Readers, unless it is Already Queued or being Read
+		void scheduleRead(const std::size_t p_stream)
+		{
+			auto& stream = *m_streams[p_stream];
+			if (stream.m_reading.exchange(true, std::memory_order_acq_rel))
+				return;
+
+			m_read_tasks.pushBack(p_stream);
+			m_signal.notify();
+		}
+
+		// Body of a Reader Thread
+		void read()
+		{
+			while (true)
+			{
+				std::size_t task		  = 0;
+				bool			found_task = false;
+				m_signal.waitUntil([&] { return finished() || (found_task = m_read_tasks.stealFront(task)); });
+				if (!found_task)
+					return;
+
+				readFrame(task);
+			}
+		}
+
+		// Reads a Single Frame, then Queues the Stream again Behind the Others if it still has a Free Frame
+		// Once the Source Ends, or Fails, m_decoded is Closed, so the Stream is Retired
+		void readFrame(const std::size_t p_stream)
+		{
+			auto& stream = *m_streams[p_stream];
+
+			// Only Scheduled with a Free Frame, and only ever Read by One Reader at a Time
+			cv::Mat* frame;
+			if (!stream.m_free.tryPop(frame))
+			{
+				rescheduleRead(p_stream);
+				return;
+			}
+
+			bool read = false;
+			try
+			{
+				read = !m_stop.load(std::memory_order_acquire) && stream.m_read(*frame) && !std::empty(*frame);
+			}
+			catch (...)
+			{
+				fail();
+			}
+
+			if (!read)
+			{
+				// m_reading Stays Set, so the Stream is never Read again
+				stream.m_decoded.close();
+				schedule(p_stream);
+				return;
+			}
+
+			stream.m_decoded.tryPush(frame);
+			schedule(p_stream);
+			rescheduleRead(p_stream);
+		}
+
+		// Lets a Detection Thread Schedule the Stream's Reading Again
+		// Unless a Frame was Freed Meanwhile, in which case it is Queued Right Away
+		void rescheduleRead(const std::size_t p_stream)
+		{
+			auto& stream = *m_streams[p_stream];
+			stream.m_reading.store(false, std::memory_order_release);
+			// Pairs with the Fence in the Detection Thread's Push to m_free
+			// Either this Thread Sees the Frame, or the Detection Thread Sees the Stream Unscheduled
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (!std::empty(stream.m_free))
+				scheduleRead(p_stream);
+		}
+
+		bool findTask(const std::size_t p_self, std::size_t& p_task)
+		{
+			if (m_queues[p_self].popBack(p_task))
+				return true;
+
+			const auto workers = getWorkerCount();
+			for (std::size_t i = 1; i < workers; ++i)
+				if (m_queues[(p_self + i) % workers].stealFront(p_task))
+					return true;
+
+			return false;
+		}
+
+		// Body of a Detection Thread
+		void work(const std::size_t p_self)
+		{
+			while (true)
+			{
+				// Fewer Runnable Streams than Threads
+				// Schedule Notifies after Queueing, so the Wait needs no Timeout
+				std::size_t task	  = 0;
+				bool			found_task = false;
+				m_signal.waitUntil([&] { return finished() || (found_task = findTask(p_self, task)); });
+				if (!found_task)
+					return;
+
+				bool retired = false;
+				try
+				{
+					retired = step(p_self, task);
+				}
+				catch (...)
+				{
+					fail();
+				}
+
+				if (retired && m_active.fetch_sub(1, std::memory_order_acq_rel) == 1)
+					m_signal.notify();
+			}
+		}
+
+		// Detects and Reports a Single Decoded Frame
+		// Returns true once the Stream has Ended and is Retired
+		bool step(const std::size_t p_self, const std::size_t p_stream)
+		{
+			auto& stream = *m_streams[p_stream];
+			stream.m_home.store(p_self, std::memory_order_relaxed);
+
+			// Frames are only Taken here, so a Stream Queued with Nothing Decoded has Ended
+			// Retired Streams Stay Scheduled, so they are never Queued Again
+			cv::Mat* frame;
+			if (!stream.m_decoded.tryPop(frame))
+			{
+				if (!stream.m_decoded.isClosed())
+				{
+					reschedule(p_stream);
+					return false;
+				}
+				// Frames Decoded before Closing are Visible by now
+				if (!stream.m_decoded.tryPop(frame))
+					return true;
+			}
+
+			const auto circle = stream.m_detector.detectCircularObjectCenters(*frame);
+			if (stream.m_callback)
+				stream.m_callback(p_stream, stream.m_frame_index, circle);
+			++stream.m_frame_index;
+
+			stream.m_free.tryPush(frame);
+			scheduleRead(p_stream);
+			reschedule(p_stream);
+			return false;
+		}
+
+		// Lets the Reader Schedule the Stream Again
+		// Unless a Frame, or the End, Arrived Meanwhile, in which case it is Queued Right Away
+		void reschedule(const std::size_t p_stream)
+		{
+			auto& stream = *m_streams[p_stream];
+			stream.m_scheduled.store(false, std::memory_order_release);
+			// Pairs with the Fence in the Reader's Push
+			// Either this Thread Sees the Frame, or the Reader Sees the Stream Unscheduled
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (!std::empty(stream.m_decoded) || stream.m_decoded.isClosed())
+				schedule(p_stream);
+		}
+	};
+
+	using StreamPool = BasicStreamPool<>;
+} // namespace Detector
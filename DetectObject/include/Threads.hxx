@@ -0,0 +1,41 @@
+#pragma once
+
+#include <exception>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Detector
+{
+	// Joins Every Thread Started, even if Starting Another Throws
+	// In which case p_stop is Called First, so the Join does not Wait for Work that only a Stop Ends
+	// Stop is Anything Callable as void() noexcept, such as a Lambda Calling requestStop
+	template <typename Stop>
+	struct Threads
+	{
+	 private:
+		Stop							 m_stop;
+		std::vector<std::thread> m_threads;
+
+	 public:
+		explicit Threads(Stop p_stop) : m_stop{std::move(p_stop)}
+		{
+		}
+		Threads(const Threads&) = delete;
+		Threads& operator=(const Threads&) = delete;
+		~Threads()
+		{
+			if (std::uncaught_exceptions() > 0)
+				m_stop();
+			for (auto& thread : m_threads)
+				if (thread.joinable())
+					thread.join();
+		}
+
+		template <typename Function>
+		void start(Function&& p_function)
+		{
+			m_threads.emplace_back(std::forward<Function>(p_function));
+		}
+	};
+} // namespace Detector
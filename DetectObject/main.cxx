@@ -1,6 +1,7 @@
 #include <iostream>
 
 #include "include/CircularObjectDetector.hxx"
+#include "include/Pipeline.hxx"
 #include "include/Window.hxx"
 
 int main()
@@ -22,37 +23,37 @@ int main()
 		 // https://stackoverflow.com/questions/17474020/finding-exact-hsv-values-of-colors
 		 .setColourBounds(cv::Scalar{115, 50, 50}, cv::Scalar{116, 255, 255})
 		 .setCannyThreshold(100, 100)
+		 .setFusedProcessing(true)
 		 .setFramesPerSecond(2);
 
 	Detector::Detector detector{props};
 
-	cv::Mat img;
-	while (true)
-	{
-		cv::Mat src;
-		video >> src;
+	// Decoding, Processing and Contour Analysis each Run on their Own Thread
+	// The Sink below Runs on this Thread so the Windows can be Updated from it
+	Detector::Pipeline pipeline{detector, 4, Detector::BackPressurePolicy::BLOCK};
 
-		if (std::empty(src))
-			break;
+	cv::Mat img;
+	pipeline.run(video, [&img](const Detector::Frame& frame) {
+		const auto& src = frame.getImage();
 
 		if (std::empty(img))
 			img = cv::Mat::zeros(src.rows, src.cols, src.type());
 
-		const auto circle = detector.detectCircularObjectCenters(src);
+		const auto circle = frame.getCircle();
 		if (!std::empty(circle))
 		{
 			cv::circle(img, circle.getCenter(), 2, {0, 255, 0}, 3);
-			
+
 			UI::Window motion{"images"};
 			motion.displayImage(img);
-			
+
 			UI::Window source{"src"};
 			source.displayImage(src);
 			source.move(800,0);
 
 			UI::Window::waitKey(500);
 		}
-	}
+	});
 	UI::Window motion{"images"};
 	motion.displayImage(img);
 	UI::Window::waitKey();
@@ -0,0 +1,331 @@
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <vector>
+
+#if defined(__GLIBC__)
+#include <dlfcn.h>
+#include <execinfo.h>
+#endif
+
+#include <opencv2/core/core.hpp>
+
+#include "include/Fixtures.hxx"
+#include "include/SyntheticVideo.hxx"
+
+// Counts Heap Allocations per Frame once the Detector is Warmed Up
+// For the Chain and the Fused Path, with and without a Background Subtractor
+// Split into processImage and findCircularObject, the Two Halves of detectCircularObjectCenters
+// Canny, findContours and the Subtractors Allocate Internally, so those Counts are not Zero
+// Allocations are also Traced back to their Caller, and Counted as the Detector's Own
+// When Made by its Containers, or by the cv::Mat Members it Calls to Manage its Buffers
+// Each Configuration then Runs again on a Single Frame Repeated, where Nothing Changes
+// Fails if the Detector Allocates on its Own there, if the Count per Frame Changes at All
+// Or if processImage on the Fused Path without a Subtractor Allocates at All
+// Prints the Counts as JSON
+namespace
+{
+	std::atomic<bool>			 g_counting{false};
+	std::atomic<std::uint64_t> g_allocations{0};
+	std::atomic<std::uint64_t> g_own_allocations{0};
+
+#if defined(__GLIBC__)
+	// Set once OpenCV is Known to be a Shared Library, so its Frames can be Told Apart
+	bool g_tracing = false;
+	// Load Address of this Executable, where the Detector's Inline Code Lives
+	const void* g_executable = nullptr;
+
+	thread_local bool t_tracing = false;
+
+	bool isOpenCV(const Dl_info& p_info) noexcept
+	{
+		return p_info.dli_fname != nullptr && std::strstr(p_info.dli_fname, "libopencv") != nullptr;
+	}
+
+	// Walks Outwards from the Allocation, past the Hooks below and the C and C++ Runtimes
+	// Reaching this Executable first Means a Container of the Detector Grew
+	// Reaching it through OpenCV Means OpenCV Allocated
+	// Unless the OpenCV Function the Detector Called was a cv::Mat Member, such as create
+	bool isOwnAllocation() noexcept
+	{
+		void*		 frames[64];
+		const auto depth = backtrace(frames, 64);
+
+		bool			in_hooks = true;
+		const char* entry	 = nullptr;
+		for (int i = 0; i < depth; ++i)
+		{
+			Dl_info info;
+			if (dladdr(frames[i], &info) == 0)
+				continue;
+
+			const auto executable = info.dli_fbase == g_executable;
+			if (in_hooks)
+			{
+				in_hooks = executable;
+				if (in_hooks)
+					continue;
+			}
+
+			if (executable)
+				return entry == nullptr || std::strncmp(entry, "_ZN2cv3Mat", 10) == 0 ||
+						 std::strncmp(entry, "_ZNK2cv3Mat", 11) == 0;
+			if (isOpenCV(info))
+				entry = info.dli_sname != nullptr ? info.dli_sname : "";
+		}
+		return false;
+	}
+
+	void startTracing() noexcept
+	{
+		Dl_info info;
+		if (dladdr(reinterpret_cast<void*>(&startTracing), &info) == 0)
+			return;
+		g_executable = info.dli_fbase;
+
+		Dl_info opencv;
+		if (dladdr(reinterpret_cast<void*>(&cv::getNumThreads), &opencv) == 0 || !isOpenCV(opencv))
+			return;
+
+		// The First Backtrace Loads the Unwinder, which Allocates
+		void* frames[1];
+		backtrace(frames, 1);
+		g_tracing = true;
+	}
+#else
+	void startTracing() noexcept
+	{
+	}
+#endif
+
+	inline void countAllocation() noexcept
+	{
+		if (!g_counting.load(std::memory_order_relaxed))
+			return;
+		g_allocations.fetch_add(1, std::memory_order_relaxed);
+
+#if defined(__GLIBC__)
+		if (!g_tracing || t_tracing)
+			return;
+		t_tracing = true;
+		if (isOwnAllocation())
+			g_own_allocations.fetch_add(1, std::memory_order_relaxed);
+		t_tracing = false;
+#endif
+	}
+
+	// Whether Own Allocations can be Told Apart Here
+	bool isTracing() noexcept
+	{
+#if defined(__GLIBC__)
+		return g_tracing;
+#else
+		return false;
+#endif
+	}
+} // namespace
+
+#if defined(__GLIBC__)
+// Every Allocation, including cv::fastMalloc and operator new, goes through these
+extern "C"
+{
+	void* __libc_malloc(std::size_t);
+	void* __libc_calloc(std::size_t, std::size_t);
+	void* __libc_realloc(void*, std::size_t);
+	void* __libc_memalign(std::size_t, std::size_t);
+	void  __libc_free(void*);
+
+	void* malloc(std::size_t p_size)
+	{
+		countAllocation();
+		return __libc_malloc(p_size);
+	}
+	void* calloc(std::size_t p_count, std::size_t p_size)
+	{
+		countAllocation();
+		return __libc_calloc(p_count, p_size);
+	}
+	void* realloc(void* p_ptr, std::size_t p_size)
+	{
+		countAllocation();
+		return __libc_realloc(p_ptr, p_size);
+	}
+	void* memalign(std::size_t p_alignment, std::size_t p_size)
+	{
+		countAllocation();
+		return __libc_memalign(p_alignment, p_size);
+	}
+	void* aligned_alloc(std::size_t p_alignment, std::size_t p_size)
+	{
+		countAllocation();
+		return __libc_memalign(p_alignment, p_size);
+	}
+	int posix_memalign(void** p_ptr, std::size_t p_alignment, std::size_t p_size)
+	{
+		countAllocation();
+		*p_ptr = __libc_memalign(p_alignment, p_size);
+		return *p_ptr != nullptr ? 0 : ENOMEM;
+	}
+	void free(void* p_ptr)
+	{
+		__libc_free(p_ptr);
+	}
+}
+#else
+// Elsewhere only C++ Allocations can be Seen
+void* operator new(std::size_t p_size)
+{
+	countAllocation();
+	if (auto* ptr = std::malloc(p_size == 0 ? 1 : p_size))
+		return ptr;
+	throw std::bad_alloc{};
+}
+void operator delete(void* p_ptr) noexcept
+{
+	std::free(p_ptr);
+}
+#endif
+
+namespace
+{
+	using Detector::BackGroundSubtractorTypes;
+
+	constexpr int kWarmUpFrames  = 10;
+	constexpr int kCountedFrames = 100;
+
+	struct Configuration
+	{
+		const char*					 name;
+		BackGroundSubtractorTypes subtractor;
+		bool							 fused_processing;
+	};
+
+	const Configuration kConfigurations[] = {{"chain", BackGroundSubtractorTypes::NONE, false},
+														  {"fused", BackGroundSubtractorTypes::NONE, true},
+														  {"chain_mog2", BackGroundSubtractorTypes::MOG2, false},
+														  {"fused_mog2", BackGroundSubtractorTypes::MOG2, true}};
+
+	Benchmark::Scene makeScene()
+	{
+		Benchmark::Scene scene;
+		scene.setSize({640, 480})
+			 .setFrameCount(kWarmUpFrames + kCountedFrames)
+			 .setBackground(Benchmark::Background::CLUTTER, 10);
+		return scene;
+	}
+
+	// Rendered before Counting, as Drawing them Allocates
+	std::vector<cv::Mat> makeFrames(const Benchmark::Scene& p_scene)
+	{
+		std::vector<cv::Mat>		  frames;
+		Benchmark::SyntheticVideo video{p_scene};
+		cv::Mat						  frame;
+		while (video.read(frame))
+			frames.push_back(frame.clone());
+		return frames;
+	}
+
+	struct Counts
+	{
+		std::uint64_t process_image		 = 0;
+		std::uint64_t find_circular_object = 0;
+		std::uint64_t own					 = 0;
+		// Fewest and Most Allocations of any Single Counted Frame
+		std::uint64_t fewest_per_frame = UINT64_MAX;
+		std::uint64_t most_per_frame	 = 0;
+	};
+
+	// Runs the Two Halves of Detector::detectCircularObjectCenters Separately
+	// Counting the Allocations of Each, once Warmed Up
+	Counts countAllocations(const Benchmark::Scene&		 p_scene,
+									const Configuration&			 p_configuration,
+									const std::vector<cv::Mat>& p_frames)
+	{
+		auto props = Benchmark::makeCharacteristics(p_scene);
+		props.setBackGroundSubtractor(p_configuration.subtractor).setFusedProcessing(p_configuration.fused_processing);
+
+		Detector::Detector detector{props};
+		cv::Mat				 mask;
+		Counts				 counts;
+
+		for (std::size_t i = 0; i < std::size(p_frames); ++i)
+		{
+			const bool counted = i >= static_cast<std::size_t>(kWarmUpFrames);
+
+			g_allocations.store(0);
+			g_own_allocations.store(0);
+			g_counting.store(counted);
+			detector.processImage(p_frames[i], mask);
+			g_counting.store(false);
+			const auto process_image = g_allocations.load();
+			counts.own += g_own_allocations.load();
+
+			g_allocations.store(0);
+			g_own_allocations.store(0);
+			g_counting.store(counted);
+			detector.findCircularObject(mask);
+			g_counting.store(false);
+			const auto find_circular_object = g_allocations.load();
+			counts.own += g_own_allocations.load();
+
+			if (!counted)
+				continue;
+			counts.process_image += process_image;
+			counts.find_circular_object += find_circular_object;
+			counts.fewest_per_frame = std::min(counts.fewest_per_frame, process_image + find_circular_object);
+			counts.most_per_frame	= std::max(counts.most_per_frame, process_image + find_circular_object);
+		}
+		return counts;
+	}
+
+	double perFrame(const std::uint64_t p_count) noexcept
+	{
+		return static_cast<double>(p_count) / kCountedFrames;
+	}
+} // namespace
+
+int main()
+{
+	startTracing();
+
+	const auto scene	= makeScene();
+	const auto frames = makeFrames(scene);
+	// Headers Sharing the First Frame, so Every Frame is the Same
+	const std::vector<cv::Mat> repeated(std::size(frames), frames.front());
+
+	// processImage on the Fused Path without a Subtractor is Entirely the Detector's Own Code
+	bool fused_free = true;
+	// On a Repeated Frame, the Detector Owns Nothing New and OpenCV Allocates the Same Every Frame
+	bool steady = true;
+
+	std::cout << "{\n  \"benchmark\": \"allocations\",\n  \"warm_up_frames\": " << kWarmUpFrames
+				 << ",\n  \"frames\": " << kCountedFrames << ",\n  \"own_allocations_traced\": " << std::boolalpha
+				 << isTracing() << ",\n  \"results\": [";
+	for (std::size_t i = 0; i < std::size(kConfigurations); ++i)
+	{
+		const auto& configuration = kConfigurations[i];
+		const auto	counts		  = countAllocations(scene, configuration, frames);
+		const auto	repeats		  = countAllocations(scene, configuration, repeated);
+
+		if (configuration.fused_processing && configuration.subtractor == BackGroundSubtractorTypes::NONE)
+			fused_free = fused_free && counts.process_image == 0;
+		const auto constant = repeats.fewest_per_frame == repeats.most_per_frame;
+		steady				  = steady && constant && repeats.own == 0;
+
+		std::cout << (i == 0 ? "\n" : ",\n") << "    {\"configuration\": \"" << configuration.name
+					 << "\", \"process_image_per_frame\": " << perFrame(counts.process_image)
+					 << ", \"find_circular_object_per_frame\": " << perFrame(counts.find_circular_object)
+					 << ", \"total_per_frame\": " << perFrame(counts.process_image + counts.find_circular_object)
+					 << ", \"own_per_frame\": " << perFrame(counts.own) << ",\n     \"repeated_frame\": {\"fewest_per_frame\": "
+					 << repeats.fewest_per_frame << ", \"most_per_frame\": " << repeats.most_per_frame
+					 << ", \"own\": " << repeats.own << ", \"constant\": " << constant << "}}";
+	}
+	std::cout << "\n  ],\n  \"fused_process_image_allocation_free\": " << fused_free
+				 << ",\n  \"steady_on_repeated_frame\": " << steady << "\n}\n";
+
+	return fused_free && steady ? 0 : 1;
+}
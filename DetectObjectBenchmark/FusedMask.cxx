@@ -0,0 +1,95 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "include/Fixtures.hxx"
+#include "include/SyntheticVideo.hxx"
+
+// Compares Detector::processImage with and without Characteristics::setFusedProcessing
+// Fails if the Masks Differ in a Single Pixel
+// Prints the Timings as JSON
+// Along with Estimates of the Memory Traffic, Worked Out from the Image Size, not Measured
+namespace
+{
+	constexpr int kWarmUpFrames = 3;
+	constexpr int kTimedFrames	 = 20;
+
+	// Estimated Bytes Read and Written per Pixel, as if no Intermediate Stayed in Cache
+	// cvtColor 3+3, inRange 3+1, GaussianBlur 1+1 and 4 Morphological Passes of 1+1
+	// Real Traffic is Lower whenever Rows are Still Cached, so these are Upper Bounds
+	constexpr std::uint64_t kChainBytesPerPixel = 20;
+	// BGR in, Mask out
+	constexpr std::uint64_t kFusedBytesPerPixel = 4;
+
+	// Heavy Noise, so Every Hue and Saturation Reaches the Mask
+	Benchmark::Scene makeScene(const cv::Size& p_size)
+	{
+		Benchmark::Scene scene;
+		scene.setSize(p_size).setFrameCount(1).setCircleCount(8).setBackground(Benchmark::Background::CLUTTER, 64);
+		return scene;
+	}
+
+	cv::Mat makeFrame(const Benchmark::Scene& p_scene)
+	{
+		cv::Mat frame;
+		Benchmark::SyntheticVideo{p_scene}.read(frame);
+		return frame;
+	}
+
+	template <typename Function>
+	double millisecondsPerFrame(Function p_function)
+	{
+		for (int i = 0; i < kWarmUpFrames; ++i)
+			p_function();
+
+		const auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < kTimedFrames; ++i)
+			p_function();
+		const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+		return elapsed.count() / kTimedFrames;
+	}
+} // namespace
+
+int main()
+{
+	const cv::Size sizes[] = {{1920, 1080}, {3840, 2160}};
+
+	bool bit_exact = true;
+
+	std::cout << "{\n  \"benchmark\": \"fused_mask\",\n  \"results\": [";
+	for (std::size_t i = 0; i < std::size(sizes); ++i)
+	{
+		const auto scene = makeScene(sizes[i]);
+		const auto frame = makeFrame(scene);
+		const auto props = Benchmark::makeCharacteristics(scene);
+
+		// No Background Subtractor, so the Output is just the Mask
+		Detector::Detector chain{props};
+		Detector::Detector fused{Detector::Characteristics{props}.setFusedProcessing(true)};
+
+		cv::Mat chain_mask;
+		cv::Mat fused_mask;
+		const auto chain_ms = millisecondsPerFrame([&] { chain_mask = chain.processImage(frame); });
+		const auto fused_ms = millisecondsPerFrame([&] { fused_mask = fused.processImage(frame); });
+
+		cv::Mat difference;
+		cv::compare(chain_mask, fused_mask, difference, cv::CMP_NE);
+		const auto mismatches = cv::countNonZero(difference);
+		bit_exact				 = bit_exact && mismatches == 0;
+
+		const auto pixels = static_cast<std::uint64_t>(sizes[i].area());
+		std::cout << (i == 0 ? "\n" : ",\n") << "    {\"width\": " << sizes[i].width
+					 << ", \"height\": " << sizes[i].height << ", \"chain_ms\": " << chain_ms
+					 << ", \"fused_ms\": " << fused_ms << ", \"speedup\": " << chain_ms / fused_ms
+					 << ", \"estimated_chain_bytes_per_frame\": " << pixels * kChainBytesPerPixel
+					 << ", \"estimated_fused_bytes_per_frame\": " << pixels * kFusedBytesPerPixel
+					 << ", \"mismatched_pixels\": " << mismatches << "}";
+	}
+	std::cout << "\n  ],\n  \"bit_exact\": " << std::boolalpha << bit_exact << "\n}\n";
+
+	return bit_exact ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "../DetectObject/include/Pipeline.hxx"
+#include "include/Fixtures.hxx"
+#include "include/SyntheticVideo.hxx"
+
+// Runs the Same Synthetic Video through Detector::Pipeline, with BackPressurePolicy::BLOCK
+// And through the Serial Loop of detectCircularObjectCenters
+// Fails unless Every Frame Arrives, in Order, with Exactly the Same Circle
+// Both Detectors are Instrumented, and must also Count the Same Frames and Contours
+// Prints the Outcome per Configuration as JSON
+namespace
+{
+	using Detector::BackGroundSubtractorTypes;
+	using InstrumentedDetector = Detector::BasicDetector<Detector::Instrumentation>;
+
+	const Detector::Counter kCounters[] = {Detector::Counter::FRAMES,
+														Detector::Counter::FRAMES_WITHOUT_DETECTION,
+														Detector::Counter::CONTOURS_FOUND,
+														Detector::Counter::CONTOURS_REJECTED};
+
+	struct Configuration
+	{
+		const char*					 name;
+		BackGroundSubtractorTypes subtractor;
+		bool							 fused_processing;
+	};
+
+	// Subtractors Carry State from Frame to Frame, so they Catch Frames Handled Out of Order
+	const Configuration kConfigurations[] = {{"NONE", BackGroundSubtractorTypes::NONE, false},
+														  {"NONE_FUSED", BackGroundSubtractorTypes::NONE, true},
+														  {"MOG2", BackGroundSubtractorTypes::MOG2, false},
+														  {"KNN_FUSED", BackGroundSubtractorTypes::KNN, true},
+														  {"CNT", BackGroundSubtractorTypes::CNT, false}};
+
+	Detector::Characteristics makeCharacteristics(const Benchmark::Scene& p_scene, const Configuration& p_configuration)
+	{
+		auto props = Benchmark::makeCharacteristics(p_scene);
+		props.setBackGroundSubtractor(p_configuration.subtractor).setFusedProcessing(p_configuration.fused_processing);
+		return props;
+	}
+
+	bool same(const Shape::Circle<>& p_first, const Shape::Circle<>& p_second) noexcept
+	{
+		if (std::empty(p_first) || std::empty(p_second))
+			return std::empty(p_first) == std::empty(p_second);
+		return p_first.getCenterX() == p_second.getCenterX() && p_first.getCenterY() == p_second.getCenterY() &&
+				 p_first.getRadius() == p_second.getRadius();
+	}
+} // namespace
+
+int main()
+{
+	Benchmark::Scene scene;
+	scene.setSize({320, 240}).setFrameCount(120).setCircleCount(3).setBackground(Benchmark::Background::CLUTTER, 10);
+
+	bool identical = true;
+
+	std::cout << "{\n  \"check\": \"pipeline\",\n  \"results\": [";
+	for (std::size_t i = 0; i < std::size(kConfigurations); ++i)
+	{
+		const auto& configuration = kConfigurations[i];
+
+		std::vector<Shape::Circle<>>		serial;
+		Detector::InstrumentationSnapshot serial_counts;
+		{
+			InstrumentedDetector		  detector{makeCharacteristics(scene, configuration)};
+			Benchmark::SyntheticVideo video{scene};
+			cv::Mat						  frame;
+			while (video.read(frame))
+				serial.push_back(detector.detectCircularObjectCenters(frame));
+			serial_counts = detector.getInstrumentation().snapshot();
+		}
+
+		std::vector<Shape::Circle<>>		piped;
+		Detector::InstrumentationSnapshot piped_counts;
+		std::uint64_t							out_of_order = 0;
+		{
+			InstrumentedDetector												detector{makeCharacteristics(scene, configuration)};
+			Detector::BasicPipeline<Detector::Instrumentation> pipeline{detector, 4, Detector::BackPressurePolicy::BLOCK};
+			Benchmark::SyntheticVideo video{scene};
+			pipeline.run(video, [&](const Detector::Frame& p_frame) {
+				if (p_frame.getIndex() != std::size(piped))
+					++out_of_order;
+				piped.push_back(p_frame.getCircle());
+			});
+			piped_counts = detector.getInstrumentation().snapshot();
+		}
+
+		std::uint64_t mismatches = 0;
+		for (std::size_t j = 0; j < std::min(std::size(serial), std::size(piped)); ++j)
+			if (!same(serial[j], piped[j]))
+				++mismatches;
+
+		bool same_counts = true;
+		for (const auto counter : kCounters)
+			same_counts = same_counts && serial_counts.getCounter(counter) == piped_counts.getCounter(counter);
+
+		const auto passed =
+			 mismatches == 0 && out_of_order == 0 && same_counts && std::size(serial) == std::size(piped);
+		identical			= identical && passed;
+
+		std::cout << (i == 0 ? "\n" : ",\n") << "    {\"configuration\": \"" << configuration.name
+					 << "\", \"serial_frames\": " << std::size(serial) << ", \"pipeline_frames\": " << std::size(piped)
+					 << ", \"out_of_order\": " << out_of_order << ", \"mismatched_frames\": " << mismatches
+					 << ", \"same_counters\": " << std::boolalpha << same_counts << ", \"passed\": " << passed << "}";
+	}
+	std::cout << "\n  ],\n  \"identical\": " << std::boolalpha << identical << "\n}\n";
+
+	return identical ? 0 : 1;
+}
@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include "include/Fixtures.hxx"
+#include "include/SyntheticVideo.hxx"
+
+// Checks Detector::detectCircularObjects against the Ground Truth of a Synthetic Video
+// Whose Circles Share their Lanes' Colour with Squares as Wide as the Largest Circle
+// Every Contour is Scored Once with no Minimum, to Check that the Default Minimum Score Separates them
+// Then the Default Characteristics must Report Every Circle, Best First, and Never a Square
+// Prints the Scores and Counts as JSON
+namespace
+{
+	constexpr int kCircles = 3;
+	constexpr int kSquares = 3;
+} // namespace
+
+int main()
+{
+	Benchmark::Scene scene;
+	// Little Noise, so Grey Pixels never Pass the Saturation Bound and Add Specks
+	scene.setSize({640, 480})
+		 .setFrameCount(200)
+		 .setCircleCount(kCircles)
+		 .setSquareCount(kSquares)
+		 .setBackground(Benchmark::Background::CLUTTER, 4);
+
+	const auto props			 = Benchmark::makeCharacteristics(scene);
+	const auto minimum_score = props.getMinimumScore();
+
+	// Every Contour, with no Minimum Score
+	Detector::Detector scorer{Detector::Characteristics{props}.setMinimumScore(0)};
+	Detector::Detector detector{props};
+
+	std::vector<Shape::Circle<>> circles;
+	std::vector<cv::RotatedRect> squares;
+	std::vector<Shape::Circle<>> found;
+	std::vector<float>			  scores;
+
+	auto			  lowest_circle_score  = std::numeric_limits<float>::max();
+	auto			  highest_square_score = 0.0f;
+	std::uint64_t circles_scored		  = 0;
+	std::uint64_t squares_scored		  = 0;
+
+	std::uint64_t frames				= 0;
+	std::uint64_t circles_expected = 0;
+	std::uint64_t circles_reported = 0;
+	std::uint64_t squares_reported = 0;
+	std::uint64_t others_reported	 = 0;
+	std::uint64_t out_of_order		 = 0;
+
+	Benchmark::SyntheticVideo video{scene};
+	cv::Mat						  frame;
+	while (video.read(frame, circles, squares))
+	{
+		++frames;
+
+		scorer.detectCircularObjects(frame, std::numeric_limits<std::size_t>::max(), found, scores);
+		for (std::size_t i = 0; i < std::size(found); ++i)
+			if (Benchmark::isOnAny(found[i], circles))
+			{
+				lowest_circle_score = std::min(lowest_circle_score, scores[i]);
+				++circles_scored;
+			}
+			else if (Benchmark::isOnAny(found[i], squares))
+			{
+				highest_square_score = std::max(highest_square_score, scores[i]);
+				++squares_scored;
+			}
+
+		// Room for Every Shape, so a Square would Show if it Passed
+		detector.detectCircularObjects(frame, kCircles + kSquares, found, scores);
+		circles_expected += std::size(circles);
+		for (std::size_t i = 0; i < std::size(found); ++i)
+		{
+			if (Benchmark::isOnAny(found[i], circles))
+				++circles_reported;
+			else if (Benchmark::isOnAny(found[i], squares))
+				++squares_reported;
+			else
+				++others_reported;
+
+			if (i > 0 && scores[i] > scores[i - 1])
+				++out_of_order;
+		}
+	}
+
+	const auto separated = circles_scored > 0 && squares_scored > 0 && highest_square_score < minimum_score &&
+								  lowest_circle_score >= minimum_score;
+	// A Circle may Rarely be Lost to the Edge Image, but never Many
+	const auto recall = circles_expected == 0 ? 0 : static_cast<double>(circles_reported) / circles_expected;
+	const auto passed = separated && squares_reported == 0 && others_reported == 0 && out_of_order == 0 && recall >= 0.99;
+
+	std::cout << "{\n  \"check\": \"ranking\",\n  \"frames\": " << frames << ",\n  \"minimum_score\": " << minimum_score
+				 << ",\n  \"scores\": {\"lowest_circle\": " << (circles_scored == 0 ? 0 : lowest_circle_score)
+				 << ", \"highest_square\": " << highest_square_score << ", \"circles\": " << circles_scored
+				 << ", \"squares\": " << squares_scored << "},\n  \"reported\": {\"circles\": " << circles_reported
+				 << ", \"expected_circles\": " << circles_expected << ", \"recall\": " << recall
+				 << ", \"squares\": " << squares_reported << ", \"others\": " << others_reported
+				 << ", \"out_of_order\": " << out_of_order << "},\n  \"passed\": " << std::boolalpha << passed << "\n}\n";
+
+	return passed ? 0 : 1;
+}
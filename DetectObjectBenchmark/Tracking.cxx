@@ -0,0 +1,83 @@
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+
+#include "include/Fixtures.hxx"
+#include "include/SyntheticVideo.hxx"
+
+// Runs the Same Synthetic Video through a Tracking Detector and one that Always Searches the Whole Frame
+// With a Single Circle, so Both should Find the Same One in Every Frame
+// Tracking Searches Regions of a Buffer that Earlier Searches have Left Edges in
+// Fails if that, or Anything Else, makes a Tracked Circle Differ from the Full Search
+// Prints the Outcome per Configuration as JSON
+namespace
+{
+	// Region and Frame Coordinates Round Differently in minEnclosingCircle
+	constexpr float kTolerance = 0.01f;
+
+	struct Configuration
+	{
+		const char* name;
+		bool			fused_processing;
+	};
+
+	const Configuration kConfigurations[] = {{"chain", false}, {"fused", true}};
+
+	bool same(const Shape::Circle<>& p_first, const Shape::Circle<>& p_second) noexcept
+	{
+		if (std::empty(p_first) || std::empty(p_second))
+			return std::empty(p_first) == std::empty(p_second);
+		return std::abs(p_first.getCenterX() - p_second.getCenterX()) <= kTolerance &&
+				 std::abs(p_first.getCenterY() - p_second.getCenterY()) <= kTolerance &&
+				 std::abs(p_first.getRadius() - p_second.getRadius()) <= kTolerance;
+	}
+} // namespace
+
+int main()
+{
+	Benchmark::Scene scene;
+	// Little Noise, so the Circle's Contour never Breaks Up
+	// Otherwise Tracking Rightly Settles for the Largest Contour Near it, which the Full Search may not
+	scene.setSize({640, 480}).setFrameCount(300).setCircleCount(1).setBackground(Benchmark::Background::CLUTTER, 4);
+
+	bool identical = true;
+
+	std::cout << "{\n  \"check\": \"tracking\",\n  \"results\": [";
+	for (std::size_t i = 0; i < std::size(kConfigurations); ++i)
+	{
+		const auto& configuration = kConfigurations[i];
+
+		const auto props = Benchmark::makeCharacteristics(scene).setFusedProcessing(configuration.fused_processing);
+
+		Detector::Detector full{props};
+		Detector::Detector tracking{Detector::Characteristics{props}.setTracking(true)};
+
+		std::uint64_t frames	  = 0;
+		std::uint64_t found	  = 0;
+		std::uint64_t mismatches = 0;
+
+		Benchmark::SyntheticVideo video{scene};
+		cv::Mat						  frame;
+		while (video.read(frame))
+		{
+			const auto expected = full.detectCircularObjectCenters(frame);
+			const auto tracked  = tracking.detectCircularObjectCenters(frame);
+
+			++frames;
+			if (!std::empty(expected))
+				++found;
+			if (!same(expected, tracked))
+				++mismatches;
+		}
+
+		const auto passed = mismatches == 0 && found > 0;
+		identical			= identical && passed;
+
+		std::cout << (i == 0 ? "\n" : ",\n") << "    {\"configuration\": \"" << configuration.name
+					 << "\", \"frames\": " << frames << ", \"found_by_full_search\": " << found
+					 << ", \"mismatched_frames\": " << mismatches << ", \"passed\": " << std::boolalpha << passed << "}";
+	}
+	std::cout << "\n  ],\n  \"identical\": " << std::boolalpha << identical << "\n}\n";
+
+	return identical ? 0 : 1;
+}
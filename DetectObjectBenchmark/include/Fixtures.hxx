@@ -0,0 +1,59 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "../../DetectObject/include/CircularObjectDetector.hxx"
+#include "SyntheticVideo.hxx"
+
+namespace Benchmark
+{
+	// Characteristics that Every Benchmark and Check Starts from
+	// Colour Bounds Follow the Hue of p_scene's Circles, so Scene::setColour Moves them Too
+	// From 20 Below that Hue to 10 Above, with Saturation and Value from 50 to Keep Grey Clutter Out
+	// For the Default Blue, Hue 120, that is {100, 50, 50} to {130, 255, 255}
+	inline Detector::Characteristics makeCharacteristics(const Scene& p_scene)
+	{
+		cv::Mat hsv;
+		cv::cvtColor(cv::Mat{1, 1, CV_8UC3, p_scene.getColour()}, hsv, cv::COLOR_BGR2HSV);
+		const int hue = hsv.at<cv::Vec3b>(0, 0)[0];
+
+		Detector::Characteristics props;
+		props.setColourBounds(cv::Scalar(std::max(hue - 20, 0), 50, 50), cv::Scalar(std::min(hue + 10, 180), 255, 255))
+			 .setCannyThreshold(100, 100);
+		return props;
+	}
+
+	// Distance of a Detection from the Centre of a Drawn Shape
+	inline float centreError(const Shape::Circle<>& p_found, const Shape::Circle<>& p_truth) noexcept
+	{
+		return std::hypot(p_found.getCenterX() - p_truth.getCenterX(), p_found.getCenterY() - p_truth.getCenterY());
+	}
+	inline float centreError(const Shape::Circle<>& p_found, const cv::RotatedRect& p_truth) noexcept
+	{
+		return std::hypot(p_found.getCenterX() - p_truth.center.x, p_found.getCenterY() - p_truth.center.y);
+	}
+
+	// Close Enough if within a Fifth of the Radius, or of a Square's Width
+	// But never Closer than 2 Pixels, which Small Shapes Round By
+	inline bool isOn(const Shape::Circle<>& p_found, const Shape::Circle<>& p_truth) noexcept
+	{
+		return centreError(p_found, p_truth) <= std::max(2.0f, 0.2f * p_truth.getRadius());
+	}
+	inline bool isOn(const Shape::Circle<>& p_found, const cv::RotatedRect& p_truth) noexcept
+	{
+		return centreError(p_found, p_truth) <= std::max(2.0f, 0.2f * p_truth.size.width);
+	}
+
+	template <typename Truth>
+	bool isOnAny(const Shape::Circle<>& p_found, const std::vector<Truth>& p_truths) noexcept
+	{
+		return std::any_of(std::begin(p_truths), std::end(p_truths), [&](const Truth& p_truth) {
+			return isOn(p_found, p_truth);
+		});
+	}
+} // namespace Benchmark
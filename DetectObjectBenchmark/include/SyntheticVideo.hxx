@@ -0,0 +1,309 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "../../DetectObject/include/Shapes.hxx"
+
+namespace Benchmark
+{
+	enum class Background
+	{
+		// Default Option
+		// Plain Grey with Fresh Noise in Every Frame
+		NOISE,
+		// Static Rectangles, Lines and Discs in Colours the Detector must Ignore
+		// With Fresh Noise in Every Frame
+		CLUTTER
+	};
+
+	struct Scene
+	{
+	 private:
+		cv::Size		  m_size{640, 480};
+		std::int32_t  m_circle_count = 3;
+		std::int32_t  m_square_count = 0;
+		std::int32_t  m_frame_count  = 300;
+		Background	  m_background	 = Background::NOISE;
+		double		  m_noise_sigma  = 10;
+		std::uint64_t m_seed			 = 1;
+
+		// Colour of the Moving Circles, as BGR
+		// Default is Blue, HSV Hue 120
+		cv::Scalar m_colour{200, 40, 40};
+
+	 public:
+		Scene& setSize(const cv::Size& p_size) noexcept
+		{
+			m_size = p_size;
+			return *this;
+		}
+		cv::Size getSize() const noexcept
+		{
+			return m_size;
+		}
+
+		Scene& setCircleCount(const std::int32_t p_circle_count) noexcept
+		{
+			m_circle_count = std::max(p_circle_count, 1);
+			return *this;
+		}
+		std::int32_t getCircleCount() const noexcept
+		{
+			return m_circle_count;
+		}
+
+		// Squares in the Colour of the Circles, which a Detector should Rank Below Every Circle
+		// Upright, at 45 Degrees, and at 22.5 Degrees in Turn
+		// Each in a Lane of its Own, Below the Circles
+		Scene& setSquareCount(const std::int32_t p_square_count) noexcept
+		{
+			m_square_count = std::max(p_square_count, 0);
+			return *this;
+		}
+		std::int32_t getSquareCount() const noexcept
+		{
+			return m_square_count;
+		}
+
+		Scene& setFrameCount(const std::int32_t p_frame_count) noexcept
+		{
+			m_frame_count = std::max(p_frame_count, 0);
+			return *this;
+		}
+		std::int32_t getFrameCount() const noexcept
+		{
+			return m_frame_count;
+		}
+
+		Scene& setBackground(const Background p_background, const double p_noise_sigma = 10) noexcept
+		{
+			m_background  = p_background;
+			m_noise_sigma = p_noise_sigma;
+			return *this;
+		}
+		Background getBackground() const noexcept
+		{
+			return m_background;
+		}
+		double getNoiseSigma() const noexcept
+		{
+			return m_noise_sigma;
+		}
+
+		Scene& setSeed(const std::uint64_t p_seed) noexcept
+		{
+			m_seed = p_seed;
+			return *this;
+		}
+		std::uint64_t getSeed() const noexcept
+		{
+			return m_seed;
+		}
+
+		// Note provide Colour as BGR
+		Scene& setColour(const cv::Scalar& p_colour) noexcept
+		{
+			m_colour = p_colour;
+			return *this;
+		}
+		cv::Scalar getColour() const noexcept
+		{
+			return m_colour;
+		}
+	};
+
+	// Deterministic Video of Circles Bouncing Left and Right
+	// Each Circle has its Own Horizontal Lane so Circles never Merge
+	// And a Distinct Radius, the Largest in the Top Lane
+	// So the Ground Truth is Simply the Circle in Lane 0
+	// Squares, if Any, Bounce in the Lanes Below
+	// The Same Scene always Produces the Same Frames, on Any Machine
+	struct SyntheticVideo
+	{
+	 private:
+		struct Lane
+		{
+			float m_x;
+			float m_y;
+			// Of the Circle, or Half the Diagonal of the Square
+			float m_radius;
+			float m_speed;
+			bool	m_square;
+			float m_angle;
+		};
+
+		Scene				  m_scene;
+		cv::Mat			  m_background;
+		cv::Mat			  m_noise;
+		std::vector<Lane> m_lanes;
+		std::int32_t	  m_frame_index = 0;
+
+		std::vector<Shape::Circle<>> m_circles;
+		std::vector<cv::RotatedRect> m_squares;
+
+	 public:
+		explicit SyntheticVideo(const Scene& p_scene) : m_scene{p_scene}
+		{
+			cv::RNG rng{m_scene.getSeed()};
+
+			const auto size	 = m_scene.getSize();
+			const auto circles = m_scene.getCircleCount();
+			const auto lanes	 = circles + m_scene.getSquareCount();
+			const auto lane_h	 = static_cast<float>(size.height) / lanes;
+			const auto max_r	 = std::max(2.0f, std::min(lane_h / 2 - 2, size.width / 8.0f));
+
+			const float angles[] = {0, 45, 22.5f};
+			for (int i = 0; i < lanes; ++i)
+			{
+				const bool square = i >= circles;
+				// Squares are all as Wide as the Largest Circle, and Rotated Ones still Fit their Lane
+				const auto radius = square ? max_r : std::max(2.0f, max_r * (1 - 0.5f * i / circles));
+				// Drawn One Statement at a Time, as the Order Operands are Evaluated in is Unspecified
+				const auto x			= rng.uniform(radius, std::max(radius + 1, size.width - radius));
+				const auto speed		= rng.uniform(1.0f, 6.0f);
+				const auto direction = rng.uniform(0, 2) == 0 ? -1 : 1;
+				m_lanes.push_back(
+					 Lane{x, lane_h * (i + 0.5f), radius, speed * direction, square, square ? angles[(i - circles) % 3] : 0});
+			}
+
+			m_background = cv::Mat{size, CV_8UC3, cv::Scalar::all(128)};
+			if (m_scene.getBackground() == Background::CLUTTER)
+				drawClutter(rng);
+		}
+
+		// Same Contract as cv::VideoCapture::read
+		bool read(cv::Mat& p_frame)
+		{
+			Shape::Circle<> truth{nullptr};
+			return read(p_frame, truth);
+		}
+
+		// Also Returns the Circle the Detector should Find
+		bool read(cv::Mat& p_frame, Shape::Circle<>& p_truth)
+		{
+			if (!read(p_frame, m_circles, m_squares))
+				return false;
+
+			p_truth = m_circles.front();
+			return true;
+		}
+
+		// Also Returns Every Circle, Largest First, and Every Square
+		bool read(cv::Mat& p_frame, std::vector<Shape::Circle<>>& p_circles, std::vector<cv::RotatedRect>& p_squares)
+		{
+			p_circles.clear();
+			p_squares.clear();
+			if (m_frame_index >= m_scene.getFrameCount())
+			{
+				p_frame.release();
+				return false;
+			}
+
+			// Noise Depends only on Seed and Frame Index
+			cv::RNG rng{m_scene.getSeed() * 7919 + static_cast<std::uint64_t>(m_frame_index) + 1};
+			m_noise.create(m_scene.getSize(), CV_16SC3);
+			rng.fill(m_noise, cv::RNG::NORMAL, 0, m_scene.getNoiseSigma());
+			cv::add(m_background, m_noise, p_frame, cv::noArray(), CV_8UC3);
+
+			const auto width = static_cast<float>(m_scene.getSize().width);
+			for (auto& lane : m_lanes)
+			{
+				// Drawn Where it Stands Now, before it Moves On
+				if (lane.m_square)
+					drawSquare(p_frame, lane, p_squares);
+				else
+				{
+					const cv::Point center{cvRound(lane.m_x), cvRound(lane.m_y)};
+					cv::circle(p_frame, center, cvRound(lane.m_radius), m_scene.getColour(), cv::FILLED);
+					p_circles.push_back(Shape::Circle<>{center, static_cast<float>(cvRound(lane.m_radius))});
+				}
+
+				// Bounce off the Sides
+				lane.m_x += lane.m_speed;
+				if (lane.m_x < lane.m_radius || lane.m_x > width - lane.m_radius)
+				{
+					lane.m_speed = -lane.m_speed;
+					lane.m_x		 = std::min(std::max(lane.m_x, lane.m_radius), width - lane.m_radius);
+				}
+			}
+
+			++m_frame_index;
+			return true;
+		}
+
+		std::int32_t getFrameIndex() const noexcept
+		{
+			return m_frame_index;
+		}
+
+	 private:
+		void drawSquare(cv::Mat& p_frame, const Lane& p_lane, std::vector<cv::RotatedRect>& p_squares) const
+		{
+			const auto				side = p_lane.m_radius * std::sqrt(2.0f);
+			const cv::RotatedRect square{cv::Point2f{p_lane.m_x, p_lane.m_y}, cv::Size2f{side, side}, p_lane.m_angle};
+
+			cv::Point2f corners[4];
+			square.points(corners);
+			cv::Point vertices[4];
+			for (int i = 0; i < 4; ++i)
+				vertices[i] = cv::Point{cvRound(corners[i].x), cvRound(corners[i].y)};
+
+			cv::fillConvexPoly(p_frame, vertices, 4, m_scene.getColour());
+			p_squares.push_back(square);
+		}
+
+		void drawClutter(cv::RNG& p_rng)
+		{
+			const auto size = m_scene.getSize();
+
+			// Red, Green, Yellow and Grey, all Far from Blue in Hue
+			const cv::Scalar colours[] = {{40, 40, 200}, {40, 200, 40}, {40, 200, 200}, {90, 90, 90}};
+			const auto		  colour	  = [&] { return colours[p_rng.uniform(0, 4)]; };
+			const auto		  point	  = [&] {
+				  const auto x = p_rng.uniform(0, size.width);
+				  const auto y = p_rng.uniform(0, size.height);
+				  return cv::Point{x, y};
+			};
+
+			// Every Value is Drawn into a Local First, in a Fixed Order
+			// As the Order Function Arguments are Evaluated in is Unspecified
+			// And would Otherwise Differ between Compilers
+			const int shapes = std::max(8, size.area() / 20000);
+			for (int i = 0; i < shapes; ++i)
+			{
+				const auto first = point();
+				switch (i % 3)
+				{
+					case 0:
+					{
+						const auto second = point();
+						const auto fill	= colour();
+						cv::rectangle(m_background, first, second, fill, cv::FILLED);
+						break;
+					}
+					case 1:
+					{
+						const auto second	 = point();
+						const auto fill		 = colour();
+						const auto thickness = p_rng.uniform(1, 6);
+						cv::line(m_background, first, second, fill, thickness);
+						break;
+					}
+					default:
+					{
+						const auto radius = p_rng.uniform(3, 40);
+						const auto fill	= colour();
+						cv::circle(m_background, first, radius, fill, cv::FILLED);
+						break;
+					}
+				}
+			}
+		}
+	};
+} // namespace Benchmark
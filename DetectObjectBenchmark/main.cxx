@@ -0,0 +1,464 @@
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../DetectObject/include/CircularObjectDetector.hxx"
+#include "../DetectObject/include/StreamPool.hxx"
+#include "include/Fixtures.hxx"
+#include "include/SyntheticVideo.hxx"
+
+// Runs the Detector over a Synthetic Video once per Background Subtractor
+// Needs no Display and no Input Files
+// Reports Speed, Latency, Memory and Accuracy against the Ground Truth as JSON
+// With --streams, Runs that Many Videos at once on StreamPool instead
+// And Reports the Total Speed for Each Thread Count
+// With --instrument, Detectors Record their Stages, Written as Prometheus Metrics
+namespace
+{
+	using Detector::BackGroundSubtractorTypes;
+
+	const BackGroundSubtractorTypes kSubtractors[] = {BackGroundSubtractorTypes::NONE,
+																	  BackGroundSubtractorTypes::MOG,
+																	  BackGroundSubtractorTypes::MOG2,
+																	  BackGroundSubtractorTypes::GMG,
+																	  BackGroundSubtractorTypes::CNT,
+																	  BackGroundSubtractorTypes::KNN};
+
+	const char* toString(const BackGroundSubtractorTypes p_type) noexcept
+	{
+		switch (p_type)
+		{
+			case BackGroundSubtractorTypes::NONE:
+				return "NONE";
+			case BackGroundSubtractorTypes::MOG:
+				return "MOG";
+			case BackGroundSubtractorTypes::MOG2:
+				return "MOG2";
+			case BackGroundSubtractorTypes::GMG:
+				return "GMG";
+			case BackGroundSubtractorTypes::CNT:
+				return "CNT";
+			case BackGroundSubtractorTypes::KNN:
+				return "KNN";
+		}
+		return "UNKNOWN";
+	}
+
+	struct Options
+	{
+		Benchmark::Scene scene;
+		bool				  fused_processing = false;
+		bool				  tracking			= false;
+		std::size_t		  streams			= 0;
+		std::string		  subtractor;
+		std::string		  output;
+		std::string		  instrument;
+	};
+
+	void printUsage(const char* p_program)
+	{
+		std::cerr << "Usage: " << p_program << " [options]\n"
+					 << "  --width N            Frame Width (640)\n"
+					 << "  --height N           Frame Height (480)\n"
+					 << "  --frames N           Frames per Run (300)\n"
+					 << "  --circles N          Moving Circles (3)\n"
+					 << "  --background TYPE    noise or clutter (noise)\n"
+					 << "  --noise SIGMA        Per Frame Gaussian Noise (10)\n"
+					 << "  --seed N             Scene Seed (1)\n"
+					 << "  --subtractor NAME    Only Run this Subtractor, e.g. CNT\n"
+					 << "  --fused              Use Characteristics::setFusedProcessing\n"
+					 << "  --tracking           Use Characteristics::setTracking\n"
+					 << "  --streams N          Run N Videos at once on StreamPool, for Each Thread Count\n"
+					 << "  --output FILE        Write the JSON here instead of stdout\n"
+					 << "  --instrument FILE    Record Every Stage, and Write it to FILE in the Prometheus Format\n";
+	}
+
+	bool parseArguments(const int p_argc, char** p_argv, Options& p_options)
+	{
+		auto size = p_options.scene.getSize();
+		auto noise = p_options.scene.getNoiseSigma();
+		auto background = p_options.scene.getBackground();
+
+		for (int i = 1; i < p_argc; ++i)
+		{
+			const std::string arg = p_argv[i];
+
+			if (arg == "--fused")
+			{
+				p_options.fused_processing = true;
+				continue;
+			}
+			if (arg == "--tracking")
+			{
+				p_options.tracking = true;
+				continue;
+			}
+
+			// Everything Else Takes a Value
+			if (i + 1 >= p_argc)
+				return false;
+			const std::string value = p_argv[++i];
+
+			if (arg == "--width")
+				size.width = std::stoi(value);
+			else if (arg == "--height")
+				size.height = std::stoi(value);
+			else if (arg == "--frames")
+				p_options.scene.setFrameCount(std::stoi(value));
+			else if (arg == "--circles")
+				p_options.scene.setCircleCount(std::stoi(value));
+			else if (arg == "--noise")
+				noise = std::stod(value);
+			else if (arg == "--seed")
+				p_options.scene.setSeed(std::stoull(value));
+			else if (arg == "--streams")
+				p_options.streams = std::stoul(value);
+			else if (arg == "--subtractor")
+				p_options.subtractor = value;
+			else if (arg == "--output")
+				p_options.output = value;
+			else if (arg == "--instrument")
+				p_options.instrument = value;
+			else if (arg == "--background" && (value == "noise" || value == "clutter"))
+				background = value == "noise" ? Benchmark::Background::NOISE : Benchmark::Background::CLUTTER;
+			else
+				return false;
+		}
+
+		if (size.width <= 0 || size.height <= 0)
+			return false;
+		// Scaling Runs are Timed without Instrumentation
+		if (p_options.streams > 0 && !std::empty(p_options.instrument))
+			return false;
+
+		p_options.scene.setSize(size).setBackground(background, noise);
+		return true;
+	}
+
+	// Peak Resident Set Size is only Available on Linux
+	// Where it can also be Reset between Runs
+	void resetPeakResidentSize()
+	{
+#if defined(__linux__)
+		std::ofstream{"/proc/self/clear_refs"} << "5";
+#endif
+	}
+	long peakResidentSizeKiB()
+	{
+#if defined(__linux__)
+		std::ifstream status{"/proc/self/status"};
+		std::string	  line;
+		while (std::getline(status, line))
+			if (line.compare(0, 6, "VmHWM:") == 0)
+				return std::stol(line.substr(6));
+#endif
+		return -1;
+	}
+
+	struct Result
+	{
+		BackGroundSubtractorTypes subtractor;
+		std::vector<double>		  latencies_ms;
+		double						  total_ms			  = 0;
+		long							  peak_rss_kib		  = -1;
+		std::uint64_t				  hits				  = 0;
+		std::uint64_t				  misses				  = 0;
+		std::uint64_t				  wrong				  = 0;
+		double						  center_error_sum  = 0;
+	};
+
+	Detector::Characteristics makeCharacteristics(const BackGroundSubtractorTypes p_subtractor, const Options& p_options)
+	{
+		auto props = Benchmark::makeCharacteristics(p_options.scene);
+		props.setBackGroundSubtractor(p_subtractor)
+			 .setFusedProcessing(p_options.fused_processing)
+			 .setTracking(p_options.tracking);
+		return props;
+	}
+
+	// Metric Names are Lower Case
+	std::string metricPrefix(const BackGroundSubtractorTypes p_subtractor)
+	{
+		std::string prefix = std::string{"detector_"} + toString(p_subtractor);
+		std::transform(std::begin(prefix), std::end(prefix), std::begin(prefix), [](const unsigned char p_char) {
+			return static_cast<char>(std::tolower(p_char));
+		});
+		return prefix;
+	}
+
+	// With the Instrumentation Policy, Appends the Metrics of the Run to p_metrics
+	// Each Subtractor under its Own Prefix, such as detector_mog2
+	template <typename InstrumentationPolicy>
+	Result run(const BackGroundSubtractorTypes p_subtractor, const Options& p_options, std::ostream& p_metrics)
+	{
+		const auto props = makeCharacteristics(p_subtractor, p_options);
+
+		Result result;
+		result.subtractor = p_subtractor;
+		result.latencies_ms.reserve(p_options.scene.getFrameCount());
+
+		resetPeakResidentSize();
+
+		Detector::BasicDetector<InstrumentationPolicy> detector{props};
+		Benchmark::SyntheticVideo							  video{p_options.scene};
+
+		cv::Mat			 frame;
+		Shape::Circle<> truth{nullptr};
+		while (video.read(frame, truth))
+		{
+			const auto start	= std::chrono::steady_clock::now();
+			const auto circle = detector.detectCircularObjectCenters(frame);
+			const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+			result.latencies_ms.push_back(elapsed.count());
+			result.total_ms += elapsed.count();
+
+			if (std::empty(circle))
+			{
+				++result.misses;
+				continue;
+			}
+
+			if (Benchmark::isOn(circle, truth))
+			{
+				++result.hits;
+				result.center_error_sum += Benchmark::centreError(circle, truth);
+			}
+			else
+				++result.wrong;
+		}
+
+		result.peak_rss_kib = peakResidentSizeKiB();
+
+		if constexpr (InstrumentationPolicy::kEnabled)
+			Detector::writePrometheus(p_metrics, detector.getInstrumentation().snapshot(), metricPrefix(p_subtractor));
+
+		return result;
+	}
+
+	struct ScalingResult
+	{
+		std::size_t	  threads = 0;
+		std::size_t	  readers = 0;
+		std::uint64_t frames	 = 0;
+		double		  total_ms = 0;
+	};
+
+	// Thread Counts Doubling from 2, and the Core Count Itself
+	// StreamPool Needs a Reader and a Detection Thread at Least
+	std::vector<std::size_t> threadCounts()
+	{
+		const auto				  cores = std::max(2u, std::thread::hardware_concurrency());
+		std::vector<std::size_t> counts;
+		for (std::size_t threads = 2; threads < cores; threads *= 2)
+			counts.push_back(threads);
+		counts.push_back(cores);
+		return counts;
+	}
+
+	// Every Stream is the Same Scene with its Own Seed
+	// Frames are Rendered on the Readers of StreamPool, as a Decoder would Run there
+	ScalingResult runStreams(const BackGroundSubtractorTypes p_subtractor,
+									 const Options&					  p_options,
+									 const std::size_t				  p_threads)
+	{
+		const auto props = makeCharacteristics(p_subtractor, p_options);
+
+		std::atomic<std::uint64_t> frames{0};
+		Detector::StreamPool		   pool{p_threads};
+		for (std::size_t i = 0; i < p_options.streams; ++i)
+		{
+			auto scene = p_options.scene;
+			scene.setSeed(scene.getSeed() + i);
+			pool.addStream(Benchmark::SyntheticVideo{scene},
+								props,
+								[&frames](std::size_t, std::uint64_t, const Shape::Circle<>&) {
+									frames.fetch_add(1, std::memory_order_relaxed);
+								});
+		}
+
+		const auto start = std::chrono::steady_clock::now();
+		pool.run();
+		const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+		return {pool.getThreadCount(), pool.getReaderCount(), frames.load(), elapsed.count()};
+	}
+
+	// Nearest Rank
+	double percentile(std::vector<double> p_values, const double p_percent)
+	{
+		if (std::empty(p_values))
+			return 0;
+
+		const auto rank = static_cast<std::size_t>(std::ceil(p_percent / 100 * std::size(p_values)));
+		const auto nth	 = std::begin(p_values) + (rank == 0 ? 0 : rank - 1);
+		std::nth_element(std::begin(p_values), nth, std::end(p_values));
+		return *nth;
+	}
+
+	void writeJson(std::ostream& p_out, const Options& p_options, const std::vector<Result>& p_results)
+	{
+		const auto& scene = p_options.scene;
+
+		p_out << std::fixed << std::setprecision(3);
+		p_out << "{\n  \"benchmark\": \"detector\",\n  \"scene\": {"
+				<< "\"width\": " << scene.getSize().width << ", \"height\": " << scene.getSize().height
+				<< ", \"frames\": " << scene.getFrameCount() << ", \"circles\": " << scene.getCircleCount()
+				<< ", \"background\": \"" << (scene.getBackground() == Benchmark::Background::NOISE ? "noise" : "clutter")
+				<< "\", \"noise\": " << scene.getNoiseSigma() << ", \"seed\": " << scene.getSeed() << "},\n"
+				<< "  \"fused_processing\": " << std::boolalpha << p_options.fused_processing
+				<< ",\n  \"tracking\": " << p_options.tracking << ",\n  \"instrumented\": " << !std::empty(p_options.instrument)
+				<< ",\n  \"results\": [";
+
+		for (std::size_t i = 0; i < std::size(p_results); ++i)
+		{
+			const auto& result = p_results[i];
+			const auto	frames = std::size(result.latencies_ms);
+			const auto	mean	 = frames == 0 ? 0 : result.total_ms / frames;
+
+			p_out << (i == 0 ? "\n" : ",\n") << "    {\"subtractor\": \"" << toString(result.subtractor) << "\""
+					<< ", \"frames\": " << frames << ", \"fps\": " << (result.total_ms > 0 ? 1000 * frames / result.total_ms : 0)
+					<< ", \"latency_ms\": {\"mean\": " << mean << ", \"p50\": " << percentile(result.latencies_ms, 50)
+					<< ", \"p99\": " << percentile(result.latencies_ms, 99)
+					<< ", \"max\": " << percentile(result.latencies_ms, 100) << "}"
+					<< ", \"peak_rss_kib\": ";
+			if (result.peak_rss_kib < 0)
+				p_out << "null";
+			else
+				p_out << result.peak_rss_kib;
+			p_out << ", \"accuracy\": {\"hits\": " << result.hits << ", \"misses\": " << result.misses
+					<< ", \"wrong\": " << result.wrong
+					<< ", \"detection_rate\": " << (frames == 0 ? 0 : static_cast<double>(result.hits) / frames)
+					<< ", \"mean_center_error_px\": " << (result.hits == 0 ? 0 : result.center_error_sum / result.hits)
+					<< "}}";
+		}
+		p_out << "\n  ]\n}\n";
+	}
+
+	void writeScalingJson(std::ostream&							p_out,
+								 const Options&						p_options,
+								 const BackGroundSubtractorTypes	p_subtractor,
+								 const std::vector<ScalingResult>& p_results)
+	{
+		const auto& scene = p_options.scene;
+		const auto	fps	= [](const ScalingResult& p_result) {
+			 return p_result.total_ms > 0 ? 1000 * p_result.frames / p_result.total_ms : 0;
+		};
+		// Relative to the Fewest Threads
+		const auto fewest = std::empty(p_results) ? 0 : fps(p_results.front());
+
+		p_out << std::fixed << std::setprecision(3);
+		p_out << "{\n  \"benchmark\": \"stream_pool\",\n  \"scene\": {"
+				<< "\"width\": " << scene.getSize().width << ", \"height\": " << scene.getSize().height
+				<< ", \"frames\": " << scene.getFrameCount() << ", \"circles\": " << scene.getCircleCount() << "},\n"
+				<< "  \"streams\": " << p_options.streams << ",\n  \"subtractor\": \"" << toString(p_subtractor) << "\""
+				<< ",\n  \"fused_processing\": " << std::boolalpha << p_options.fused_processing
+				<< ",\n  \"cores\": " << std::thread::hardware_concurrency() << ",\n  \"results\": [";
+
+		for (std::size_t i = 0; i < std::size(p_results); ++i)
+		{
+			const auto& result  = p_results[i];
+			const auto	speedup = fewest > 0 ? fps(result) / fewest : 0;
+			const auto	scale	  = static_cast<double>(result.threads) / p_results.front().threads;
+			p_out << (i == 0 ? "\n" : ",\n") << "    {\"threads\": " << result.threads << ", \"readers\": " << result.readers
+					<< ", \"frames\": " << result.frames << ", \"total_fps\": " << fps(result) << ", \"speedup\": " << speedup
+					<< ", \"efficiency\": " << speedup / scale << "}";
+		}
+		p_out << "\n  ]\n}\n";
+	}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	Options options;
+	try
+	{
+		if (!parseArguments(argc, argv, options))
+		{
+			printUsage(argv[0]);
+			return 2;
+		}
+	}
+	catch (const std::exception&)
+	{
+		// Numbers that do not Parse
+		printUsage(argv[0]);
+		return 2;
+	}
+
+	if (options.streams > 0)
+	{
+		// One Subtractor, NONE unless Chosen
+		auto subtractor = BackGroundSubtractorTypes::NONE;
+		if (!std::empty(options.subtractor))
+		{
+			const auto found = std::find_if(std::begin(kSubtractors), std::end(kSubtractors), [&](const auto p_type) {
+				return options.subtractor == toString(p_type);
+			});
+			if (found == std::end(kSubtractors))
+			{
+				printUsage(argv[0]);
+				return 2;
+			}
+			subtractor = *found;
+		}
+
+		std::vector<ScalingResult> scaling;
+		for (const auto threads : threadCounts())
+			scaling.push_back(runStreams(subtractor, options, threads));
+
+		if (std::empty(options.output))
+			writeScalingJson(std::cout, options, subtractor, scaling);
+		else
+		{
+			std::ofstream file{options.output};
+			writeScalingJson(file, options, subtractor, scaling);
+			if (!file)
+				return 1;
+		}
+		return 0;
+	}
+
+	std::vector<Result> results;
+	std::ostringstream  metrics;
+	for (const auto subtractor : kSubtractors)
+		if (std::empty(options.subtractor) || options.subtractor == toString(subtractor))
+			results.push_back(std::empty(options.instrument)
+										? run<Detector::NoInstrumentation>(subtractor, options, metrics)
+										: run<Detector::Instrumentation>(subtractor, options, metrics));
+
+	if (std::empty(results))
+	{
+		printUsage(argv[0]);
+		return 2;
+	}
+
+	if (!std::empty(options.instrument))
+	{
+		std::ofstream file{options.instrument};
+		file << metrics.str();
+		if (!file)
+			return 1;
+	}
+
+	if (std::empty(options.output))
+		writeJson(std::cout, options, results);
+	else
+	{
+		std::ofstream file{options.output};
+		writeJson(file, options, results);
+		if (!file)
+			return 1;
+	}
+	return 0;
+}
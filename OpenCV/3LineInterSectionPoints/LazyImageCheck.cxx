@@ -0,0 +1,89 @@
+#include "include/Image.hxx"
+
+#include <opencv2/core/core.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <iostream>
+
+// Runs chains of operations on Image, once eagerly and once lazily
+// The image is large enough to be cut into many strips
+// Then again on a part of it, which must give what a copy of the part gives
+// Fails unless every run gives exactly the same pixels
+namespace {
+using PC::OpenCV::Image;
+
+struct Chain {
+  const char *name;
+  std::function<Image(Image)> run;
+};
+
+const Chain kChains[] = {
+    {"gaussian_5x5", [](Image p_image) {
+       return p_image.GaussianBlur({5, 5}, 0);
+     }},
+    {"gaussian_sigma_1_3", [](Image p_image) {
+       return p_image.GaussianBlur({0, 0}, 1.3);
+     }},
+    {"gaussian_7x3", [](Image p_image) {
+       return p_image.GaussianBlur({7, 3}, 1.5, 0.8);
+     }},
+    {"gaussian_gaussian", [](Image p_image) {
+       return p_image.GaussianBlur({5, 5}, 0).GaussianBlur({0, 0}, 1.7);
+     }},
+    {"median_5", [](Image p_image) { return p_image.medianBlur(5); }},
+    {"gaussian_median", [](Image p_image) {
+       return p_image.GaussianBlur({3, 3}, 0).medianBlur(3);
+     }},
+    {"colour_gaussian", [](Image p_image) {
+       return p_image.changeColour().GaussianBlur({5, 5}, 0);
+     }},
+    {"gaussian_colour_median", [](Image p_image) {
+       return p_image.GaussianBlur({0, 0}, 2.5).changeColour().medianBlur(5);
+     }},
+    {"colour_median_7", [](Image p_image) {
+       return p_image.changeColour().medianBlur(7);
+     }},
+};
+
+bool same(const cv::Mat &p_first, const cv::Mat &p_second) {
+  return p_first.size() == p_second.size() &&
+         p_first.type() == p_second.type() &&
+         cv::norm(p_first, p_second, cv::NORM_INF) == 0;
+}
+} // namespace
+
+int main() {
+  // Noise, smoothed a little so the blurs have edges to round on
+  cv::Mat source{1080, 1920, CV_8UC3};
+  cv::RNG{1}.fill(source, cv::RNG::UNIFORM, 0, 256);
+  cv::GaussianBlur(source, source, {0, 0}, 2);
+
+  // Away from every edge, so OpenCV could read the pixels around it
+  const cv::Mat part = source(cv::Rect{301, 203, 1280, 720});
+
+  bool passed = true;
+  std::cout << "{\n  \"check\": \"lazy_image\",\n  \"results\": [";
+  for (std::size_t i = 0; i < std::size(kChains); ++i) {
+    const auto &chain = kChains[i];
+
+    const auto eager = chain.run(Image{source}).view();
+    const auto lazy = chain.run(Image{source}.setLazy(true)).view();
+    const auto same_whole = same(eager, lazy);
+
+    const auto part_eager = chain.run(Image{part}).view();
+    const auto part_lazy = chain.run(Image{part}.setLazy(true)).view();
+    const auto part_copy = chain.run(Image{part.clone()}).view();
+    const auto same_part =
+        same(part_eager, part_lazy) && same(part_eager, part_copy);
+
+    passed = passed && same_whole && same_part;
+
+    std::cout << (i == 0 ? "\n" : ",\n") << "    {\"chain\": \"" << chain.name
+              << "\", \"same\": " << std::boolalpha << same_whole
+              << ", \"same_for_part\": " << same_part << "}";
+  }
+  std::cout << "\n  ],\n  \"passed\": " << std::boolalpha << passed << "\n}\n";
+
+  return passed ? 0 : 1;
+}
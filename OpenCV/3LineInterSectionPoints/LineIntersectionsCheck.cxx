@@ -0,0 +1,165 @@
+#include "include/LineIntersections.hxx"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Compares LineIntersections::intersect against the old all pairs loop
+// Which tested every ordered pair with acceptLinePair
+// Fails unless both keep the same pairs, each unordered pair once
+// And every point is near one computeIntersect gave
+namespace {
+constexpr float kTolerance = 1e-3f;
+
+// As main.cxx used to have it
+bool acceptLinePair(const cv::Vec2f &line1, const cv::Vec2f &line2,
+                    const float minTheta) {
+  float theta1 = line1[1], theta2 = line2[1];
+
+  // dealing with 0 and 180 ambiguities
+  if (theta1 < minTheta)
+    theta1 += CV_PI;
+  if (theta2 < minTheta)
+    theta2 += CV_PI;
+
+  return std::abs(theta1 - theta2) > minTheta;
+}
+
+// the long nasty wikipedia line-intersection equation, as main.cxx used to have
+// it, through two points 1000 apart on each line
+std::vector<cv::Point2f> lineToPointPair(const cv::Vec2f &line) {
+  std::vector<cv::Point2f> points;
+
+  float r = line[0], t = line[1];
+  auto cos_t = std::cos(t), sin_t = std::sin(t);
+  auto x0 = r * cos_t, y0 = r * sin_t;
+  float alpha = 1000;
+
+  points.push_back(cv::Point2f(x0 + alpha * (-sin_t), y0 + alpha * cos_t));
+  points.push_back(cv::Point2f(x0 - alpha * (-sin_t), y0 - alpha * cos_t));
+
+  return points;
+}
+
+cv::Point2f computeIntersect(const cv::Vec2f &line1, const cv::Vec2f &line2) {
+  std::vector<cv::Point2f> p1 = lineToPointPair(line1);
+  std::vector<cv::Point2f> p2 = lineToPointPair(line2);
+
+  float denom = (p1[0].x - p1[1].x) * (p2[0].y - p2[1].y) -
+                (p1[0].y - p1[1].y) * (p2[0].x - p2[1].x);
+  cv::Point2f intersect(((p1[0].x * p1[1].y - p1[0].y * p1[1].x) *
+                             (p2[0].x - p2[1].x) -
+                         (p1[0].x - p1[1].x) *
+                             (p2[0].x * p2[1].y - p2[0].y * p2[1].x)) /
+                            denom,
+                        ((p1[0].x * p1[1].y - p1[0].y * p1[1].x) *
+                             (p2[0].y - p2[1].y) -
+                         (p1[0].y - p1[1].y) *
+                             (p2[0].x * p2[1].y - p2[0].y * p2[1].x)) /
+                            denom);
+
+  return intersect;
+}
+
+// The old equation loses precision to its points 1000 apart, so the two only
+// agree to within a fraction of the distance from the origin
+float tolerance(const cv::Point2f &p_expected) {
+  return kTolerance *
+         std::max({1.0f, std::abs(p_expected.x), std::abs(p_expected.y)});
+}
+
+// Pairs every expected point with a different point near it
+// Both sorted by x, so the points near one are a short run of the other
+bool matches(std::vector<cv::Point2f> p_expected,
+             std::vector<cv::Point2f> p_points) {
+  if (std::size(p_expected) != std::size(p_points))
+    return false;
+
+  const auto byX = [](const cv::Point2f &p_first,
+                      const cv::Point2f &p_second) {
+    return p_first.x < p_second.x;
+  };
+  std::sort(std::begin(p_expected), std::end(p_expected), byX);
+  std::sort(std::begin(p_points), std::end(p_points), byX);
+
+  std::vector<bool> used(std::size(p_points));
+  std::size_t first = 0;
+  for (const auto &expected : p_expected) {
+    while (first < std::size(p_points) && used[first])
+      ++first;
+
+    // The nearest, so a point close to two expected ones goes to its own
+    const auto limit = tolerance(expected);
+    auto nearest = std::size(p_points);
+    auto nearest_distance = limit;
+    for (auto i = first; i < std::size(p_points); ++i) {
+      if (p_points[i].x - expected.x > limit)
+        break;
+      const auto distance = std::max(std::abs(p_points[i].x - expected.x),
+                                     std::abs(p_points[i].y - expected.y));
+      if (!used[i] && distance <= nearest_distance) {
+        nearest = i;
+        nearest_distance = distance;
+      }
+    }
+    if (nearest == std::size(p_points))
+      return false;
+    used[nearest] = true;
+  }
+  return true;
+}
+} // namespace
+
+int main() {
+  const float min_theta = static_cast<float>(CV_PI / 32);
+
+  std::mt19937 generator{3};
+  std::uniform_real_distribution<float> rho{-300, 300};
+  std::uniform_real_distribution<float> theta{0, static_cast<float>(CV_PI)};
+
+  // Reused across sizes, as main.cxx reuses it across frames
+  PC::OpenCV::LineIntersections intersections;
+  std::vector<cv::Point2f> points;
+
+  bool passed = true;
+  std::cout << "{\n  \"check\": \"line_intersections\",\n  \"results\": [";
+  const std::size_t sizes[] = {0, 1, 2, 10, 300, 2000};
+  for (std::size_t s = 0; s < std::size(sizes); ++s) {
+    // Every fifth theta is rounded, so some lines share a theta exactly
+    // And some sit right at the 0 and 180 boundary
+    std::vector<cv::Vec2f> lines(sizes[s]);
+    for (std::size_t i = 0; i < std::size(lines); ++i)
+      lines[i] = {rho(generator), i % 5 == 0
+                                      ? std::round(theta(generator) * 20) / 20
+                                      : theta(generator)};
+
+    std::size_t ordered = 0;
+    std::vector<cv::Point2f> expected;
+    for (std::size_t i = 0; i < std::size(lines); ++i)
+      for (std::size_t j = 0; j < std::size(lines); ++j)
+        if (acceptLinePair(lines[i], lines[j], min_theta)) {
+          ++ordered;
+          if (i < j)
+            expected.push_back(computeIntersect(lines[i], lines[j]));
+        }
+
+    intersections.intersect(lines, min_theta, points);
+
+    // The pairs must be exactly the ones acceptLinePair kept
+    const auto same =
+        2 * std::size(points) == ordered && matches(expected, points);
+    passed = passed && same;
+
+    std::cout << (s == 0 ? "\n" : ",\n") << "    {\"lines\": " << sizes[s]
+              << ", \"ordered_pairs\": " << ordered
+              << ", \"expected_points\": " << std::size(expected)
+              << ", \"points\": " << std::size(points)
+              << ", \"same\": " << std::boolalpha << same << "}";
+  }
+  std::cout << "\n  ],\n  \"passed\": " << std::boolalpha << passed << "\n}\n";
+
+  return passed ? 0 : 1;
+}
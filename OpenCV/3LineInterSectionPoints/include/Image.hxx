@@ -3,6 +3,7 @@
 #include <opencv2/imgcodecs/imgcodecs.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 
+#include <algorithm>
 #include <vector>
 
 namespace PC {
@@ -13,7 +14,157 @@ struct Image {
   using BorderType = cv::BorderTypes;
 
 private:
-  cv::Mat m_img;
+  // An operation waiting to be applied, in lazy mode
+  struct Operation {
+    enum class Kind { GAUSSIAN_BLUR, MEDIAN_BLUR, CHANGE_COLOUR };
+
+    Kind m_kind;
+    cv::Size m_ksize{};
+    double m_sigma_x = 0;
+    double m_sigma_y = 0;
+    int m_border_type = cv::BORDER_DEFAULT;
+
+    // OpenCV copies the image for these
+    bool isIdentity() const noexcept {
+      return (m_kind == Kind::GAUSSIAN_BLUR && m_ksize == cv::Size{1, 1}) ||
+             (m_kind == Kind::MEDIAN_BLUR && m_ksize.width <= 1);
+    }
+
+    int outputType(const int p_type) const noexcept {
+      return m_kind == Kind::CHANGE_COLOUR
+                 ? CV_MAKETYPE(CV_MAT_DEPTH(p_type), 1)
+                 : p_type;
+    }
+
+    // Rows above and below each output row the operation reads
+    // Kernel size worked out from sigma as cv::GaussianBlur does
+    int halo(const int p_type) const noexcept {
+      switch (m_kind) {
+      case Kind::GAUSSIAN_BLUR: {
+        if (m_ksize.height > 0)
+          return m_ksize.height / 2;
+        const auto sigma = m_sigma_y > 0 ? m_sigma_y : m_sigma_x;
+        const auto scale = CV_MAT_DEPTH(p_type) == CV_8U ? 3 : 4;
+        return (cvRound(sigma * scale * 2 + 1) | 1) / 2;
+      }
+      case Kind::MEDIAN_BLUR:
+        return m_ksize.width / 2;
+      case Kind::CHANGE_COLOUR:
+        return 0;
+      }
+      return 0;
+    }
+
+    // Borders are isolated, so OpenCV never reads past p_src
+    // Neither the rows around a strip nor the pixels around a part of a Mat
+    void apply(const cv::Mat &p_src, cv::Mat &p_dst) const {
+      switch (m_kind) {
+      case Kind::GAUSSIAN_BLUR:
+        cv::GaussianBlur(p_src, p_dst, m_ksize, m_sigma_x, m_sigma_y,
+                         m_border_type | cv::BORDER_ISOLATED);
+        break;
+      case Kind::MEDIAN_BLUR:
+        cv::medianBlur(p_src, p_dst, m_ksize.width);
+        break;
+      case Kind::CHANGE_COLOUR:
+        cv::cvtColor(p_src, p_dst, CV_BGR2GRAY);
+        break;
+      }
+    }
+  };
+
+  // Strips are sized so every buffer of a strip stays in cache
+  static constexpr std::size_t kStripBytes = 256 * 1024;
+  static constexpr int kMinStripRows = 16;
+
+  // Evaluated on first read, so both change in const functions
+  mutable cv::Mat m_img;
+  mutable std::vector<Operation> m_pending;
+  bool m_lazy = false;
+
+  Image then(const Operation &p_operation) const {
+    if (!m_lazy) {
+      cv::Mat out;
+      p_operation.apply(view(), out);
+      return out;
+    }
+
+    Image result{*this};
+    if (!p_operation.isIdentity())
+      result.m_pending.push_back(p_operation);
+    return result;
+  }
+
+  // Runs the whole chain on one strip of rows before moving to the next
+  // So intermediates never leave the cache and only the result is full size
+  // Each strip is read with the halo every later operation needs
+  // Rows that end up within the halo of a cut are wrong, and are dropped
+  // So the result is exactly what applying the operations one by one gives
+  static cv::Mat evaluate(const cv::Mat &p_src,
+                          const std::vector<Operation> &p_operations) {
+    if (std::size(p_operations) == 1) {
+      cv::Mat out;
+      p_operations.front().apply(p_src, out);
+      return out;
+    }
+
+    const auto rows = p_src.rows;
+    auto type = p_src.type();
+    auto widest = p_src.cols * CV_ELEM_SIZE(type);
+    auto halo = 0;
+    for (const auto &operation : p_operations) {
+      halo += operation.halo(type);
+      type = operation.outputType(type);
+      widest = std::max(widest, p_src.cols * CV_ELEM_SIZE(type));
+    }
+
+    cv::Mat out{p_src.size(), type};
+    const auto strip = std::min(
+        rows, std::max({kMinStripRows, 4 * halo,
+                        static_cast<int>(kStripBytes /
+                                         std::max<std::size_t>(widest, 1))}));
+
+    // Intermediate buffers, one per operation, kept from call to call
+    thread_local std::vector<cv::Mat> pool;
+    if (std::size(pool) < std::size(p_operations))
+      pool.resize(std::size(p_operations));
+
+    type = p_src.type();
+    for (std::size_t i = 0; i < std::size(p_operations); ++i) {
+      type = p_operations[i].outputType(type);
+      pool[i].create(std::min(rows, strip + 2 * halo), p_src.cols, type);
+    }
+
+    for (int y0 = 0; y0 < rows; y0 += strip) {
+      const auto y1 = std::min(rows, y0 + strip);
+      auto top = std::max(0, y0 - halo);
+      auto bottom = std::min(rows, y1 + halo);
+
+      type = p_src.type();
+      auto input = p_src.rowRange(top, bottom);
+      for (std::size_t i = 0; i < std::size(p_operations); ++i) {
+        const auto &operation = p_operations[i];
+        const auto cut = operation.halo(type);
+        type = operation.outputType(type);
+
+        // Our own buffers hold stale rows past the strip, never read them
+        // Nor the rows of the source past the strip, as OpenCV takes another
+        // path for a submatrix it may read around, which rounds differently
+        auto output = pool[i].rowRange(0, bottom - top);
+        operation.apply(input, output);
+
+        const auto drop_top = top > 0 ? cut : 0;
+        const auto drop_bottom = bottom < rows ? cut : 0;
+        input = output.rowRange(drop_top, (bottom - top) - drop_bottom);
+        top += drop_top;
+        bottom -= drop_bottom;
+      }
+
+      input.rowRange(y0 - top, y1 - top).copyTo(out.rowRange(y0, y1));
+    }
+
+    return out;
+  }
 
 public:
   Image(const cv::String &p_file_name,
@@ -21,40 +172,63 @@ public:
       : m_img{cv::imread(p_file_name, p_read_mode)} {}
   Image(cv::InputArray &buffer, const Image::ReadMode p_read_mode)
       : m_img{cv::imdecode(buffer, p_read_mode)} {}
+  // Made from part of a larger Mat, the part is all there is, lazy or not
+  // Blurs never read the pixels around it
   Image(const cv::Mat &buf) : m_img{buf} {}
 
+  // In lazy mode GaussianBlur, medianBlur and changeColour only record
+  // themselves, and run together when the image is read, by view, as or write
+  // Copies share the pixels, and a copy with pending operations runs them on
+  // its own when read
+  // Errors, such as changeColour on a grey image, also wait until then
+  // Reading evaluates in place, so an image with pending operations
+  // must not be read from several threads at once
+  Image &setLazy(const bool p_lazy) noexcept {
+    m_lazy = p_lazy;
+    return *this;
+  }
+  bool isLazy() const noexcept { return m_lazy; }
+
+  // Shares the pixels, without copying
+  const cv::Mat &view() const {
+    if (!std::empty(m_pending)) {
+      m_img = evaluate(m_img, m_pending);
+      m_pending.clear();
+    }
+    return m_img;
+  }
+
   template <typename Type,
             typename = std::enable_if_t<std::is_same_v<Type, cv::Mat> ||
                                         std::is_same_v<Type, cv::InputArray>>>
-  Type as() const noexcept {
-    return m_img.clone();
+  Type as() const {
+    return view().clone();
   }
 
   Image GaussianBlur(
       const cv::Size& ksize, const double sigmaX, const double sigmaY = 0,
       const BorderType borderType = Image::BorderType::BORDER_DEFAULT) {
-    cv::Mat out;
-    cv::GaussianBlur(m_img, out, ksize, sigmaX, sigmaY, borderType);
-    return out;
+    return then(Operation{Operation::Kind::GAUSSIAN_BLUR, ksize, sigmaX,
+                          sigmaY, borderType});
   }
   Image medianBlur(const int ksize) {
-    cv::Mat out;
-    cv::medianBlur(m_img, out, ksize);
-    return out;
+    return then(
+        Operation{Operation::Kind::MEDIAN_BLUR, cv::Size{ksize, ksize}});
   }
 
+  // None of the operations change the size
   cv::Size getSize() const noexcept { return m_img.size(); }
 
   Image changeColour()
   {
-      cv::Mat out;
-      cv::cvtColor(m_img, out, CV_BGR2GRAY);
-      return out;
+      return then(Operation{Operation::Kind::CHANGE_COLOUR});
   }
 
   Image clone() const
   {
-      return m_img.clone();
+      Image copy{view().clone()};
+      copy.m_lazy = m_lazy;
+      return copy;
   }
 
   bool empty() const noexcept(noexcept(std::empty(m_img))) {
@@ -62,7 +236,7 @@ public:
   }
 
   bool write(const cv::String &p_file_name, std::vector<int> &p_write_mode) {
-    return cv::imwrite(p_file_name, p_write_mode);
+    return cv::imwrite(p_file_name, view(), p_write_mode);
   }
 };
 } // namespace OpenCV
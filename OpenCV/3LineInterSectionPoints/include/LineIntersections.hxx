@@ -0,0 +1,209 @@
+#pragma once
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/core/utility.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+
+namespace PC {
+namespace OpenCV {
+// Intersections of lines given as (rho, theta), as cv::HoughLines returns them
+// Keep one instance and reuse it, so its scratch is allocated only once
+struct LineIntersections {
+private:
+  // Below this many pairs, threads cost more than they save
+  static constexpr std::size_t kParallelPairs = 16 * 1024;
+
+  // Lines sorted by theta, one array per field
+  std::vector<std::size_t> m_order;
+  std::vector<float> m_theta;
+  std::vector<float> m_rho;
+  std::vector<float> m_cos;
+  std::vector<float> m_sin;
+
+  // Line i meets every line from m_first[i] to the end
+  // Writing its intersections from m_offset[i] on
+  std::vector<std::size_t> m_first;
+  std::vector<std::size_t> m_offset;
+
+  // Clusters, each with the point that started it and the sum of its members
+  std::unordered_map<std::uint64_t, std::size_t> m_cells;
+  std::vector<cv::Point2f> m_leaders;
+  std::vector<cv::Point2d> m_sums;
+  std::vector<std::uint32_t> m_sizes;
+
+  // Intersects a range of lines with all their partners
+  // Every line of a pair is in the same arrays, so the inner loop vectorises
+  struct IntersectBody : cv::ParallelLoopBody {
+    const LineIntersections &m_self;
+    cv::Point2f *m_points;
+
+    IntersectBody(const LineIntersections &p_self, cv::Point2f *p_points)
+        : m_self{p_self}, m_points{p_points} {}
+
+    void operator()(const cv::Range &p_range) const override {
+      const auto count = std::size(m_self.m_rho);
+      const float *rho = m_self.m_rho.data();
+      const float *cos = m_self.m_cos.data();
+      const float *sin = m_self.m_sin.data();
+
+      for (int line = p_range.start; line < p_range.end; ++line) {
+        const auto i = static_cast<std::size_t>(line);
+        const float rho_i = rho[i], cos_i = cos[i], sin_i = sin[i];
+        const auto first = m_self.m_first[i];
+        cv::Point2f *out = m_points + m_self.m_offset[i];
+
+        // Solves x cos + y sin = rho for both lines
+        for (std::size_t j = first; j < count; ++j) {
+          const float denom = cos_i * sin[j] - sin_i * cos[j];
+          out[j - first].x = (rho_i * sin[j] - rho[j] * sin_i) / denom;
+          out[j - first].y = (rho[j] * cos_i - rho_i * cos[j]) / denom;
+        }
+      }
+    }
+  };
+
+public:
+  // Intersects every unordered pair of lines whose thetas differ by more than
+  // p_min_theta, with thetas under p_min_theta taken as theta + pi
+  // The same pairs the old acceptLinePair kept, but each only once
+  // Lines are sorted by theta, so the partners of a line are all the lines
+  // from some point on, and no pair is ever tested on its own
+  void intersect(const std::vector<cv::Vec2f> &p_lines, const float p_min_theta,
+                 std::vector<cv::Point2f> &p_points) {
+    const auto count = std::size(p_lines);
+
+    // Dealing with 0 and 180 ambiguities
+    m_order.resize(count);
+    m_theta.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+      const float theta = p_lines[i][1];
+      m_theta[i] =
+          theta < p_min_theta ? static_cast<float>(theta + CV_PI) : theta;
+    }
+    std::iota(std::begin(m_order), std::end(m_order), std::size_t{0});
+    std::stable_sort(std::begin(m_order), std::end(m_order),
+                     [this](const std::size_t p_first,
+                            const std::size_t p_second) noexcept {
+                       return m_theta[p_first] < m_theta[p_second];
+                     });
+
+    m_rho.resize(count);
+    m_cos.resize(count);
+    m_sin.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+      const auto &line = p_lines[m_order[i]];
+      m_rho[i] = line[0];
+      m_cos[i] = std::cos(line[1]);
+      m_sin[i] = std::sin(line[1]);
+    }
+    // Thetas in the same order, for the search below
+    std::sort(std::begin(m_theta), std::end(m_theta));
+
+    // The first partner only ever moves forward
+    m_first.resize(count);
+    m_offset.resize(count + 1);
+    m_offset[0] = 0;
+    std::size_t partner = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+      partner = std::max(partner, i + 1);
+      while (partner < count && !(m_theta[partner] - m_theta[i] > p_min_theta))
+        ++partner;
+      m_first[i] = partner;
+      m_offset[i + 1] = m_offset[i] + (count - partner);
+    }
+
+    p_points.resize(m_offset[count]);
+    if (count == 0)
+      return;
+
+    const IntersectBody body{*this, p_points.data()};
+    if (m_offset[count] < kParallelPairs)
+      body(cv::Range{0, static_cast<int>(count)});
+    else
+      cv::parallel_for_(cv::Range{0, static_cast<int>(count)}, body);
+  }
+
+  // Merges points within p_radius of the first point of a cluster
+  // Into the mean of the cluster, in the order the clusters were started
+  // Points that are not finite, such as from nearly parallel lines, are dropped
+  void cluster(const std::vector<cv::Point2f> &p_points, const float p_radius,
+               std::vector<cv::Point2f> &p_centres) {
+    m_cells.clear();
+    m_leaders.clear();
+    m_sums.clear();
+    m_sizes.clear();
+
+    if (p_radius > 0) {
+      // Cells are small enough that no two clusters start in the same one
+      // So a leader within p_radius is at most two cells away
+      const double cell = p_radius / std::sqrt(2.0);
+      const double limit = std::numeric_limits<std::int32_t>::max();
+      const auto toCell = [&](const float p_coordinate) {
+        return static_cast<std::int32_t>(
+            std::min(std::max(std::floor(p_coordinate / cell), -limit), limit));
+      };
+      const auto toKey = [](const std::int32_t p_x, const std::int32_t p_y) {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(p_x))
+                << 32) |
+               static_cast<std::uint32_t>(p_y);
+      };
+
+      for (const auto &point : p_points) {
+        if (!std::isfinite(point.x) || !std::isfinite(point.y))
+          continue;
+
+        const auto x = toCell(point.x), y = toCell(point.y);
+
+        auto nearest = std::size(m_leaders);
+        auto nearest_distance = p_radius * p_radius;
+        for (std::int64_t dy = -2; dy <= 2; ++dy)
+          for (std::int64_t dx = -2; dx <= 2; ++dx) {
+            if (x + dx < -limit || x + dx > limit || y + dy < -limit ||
+                y + dy > limit)
+              continue;
+            const auto found =
+                m_cells.find(toKey(static_cast<std::int32_t>(x + dx),
+                                   static_cast<std::int32_t>(y + dy)));
+            if (found == std::end(m_cells))
+              continue;
+            const auto offset = m_leaders[found->second] - point;
+            const auto distance = offset.dot(offset);
+            if (distance <= nearest_distance) {
+              nearest = found->second;
+              nearest_distance = distance;
+            }
+          }
+
+        if (nearest == std::size(m_leaders)) {
+          // Cells only ever collide for points clamped at the limit
+          m_cells.emplace(toKey(x, y), nearest);
+          m_leaders.push_back(point);
+          m_sums.emplace_back(0, 0);
+          m_sizes.push_back(0);
+        }
+        m_sums[nearest] += cv::Point2d{point.x, point.y};
+        ++m_sizes[nearest];
+      }
+    } else {
+      for (const auto &point : p_points)
+        if (std::isfinite(point.x) && std::isfinite(point.y)) {
+          m_sums.emplace_back(point.x, point.y);
+          m_sizes.push_back(1);
+        }
+    }
+
+    p_centres.resize(std::size(m_sums));
+    for (std::size_t i = 0; i < std::size(m_sums); ++i)
+      p_centres[i] = cv::Point2f{static_cast<float>(m_sums[i].x / m_sizes[i]),
+                                 static_cast<float>(m_sums[i].y / m_sizes[i])};
+  }
+};
+} // namespace OpenCV
+} // namespace PC
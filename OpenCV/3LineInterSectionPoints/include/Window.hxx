@@ -60,7 +60,7 @@ namespace PC { namespace OpenCV { namespace UI
             Window& displayImage(const OpenCV::Image& p_img)
             {
                 if(!std::empty(p_img))
-                    cv::imshow(m_window_id, p_img.as<cv::Mat>());
+                    cv::imshow(m_window_id, p_img.view());
                 return *this;
             }
             cv::Rect getAsRect()
@@ -4,13 +4,11 @@
 #include <iostream>
 #include <vector>
 
+#include "include/LineIntersections.hxx"
+
 using namespace cv;
 using namespace std;
 
-Point2f computeIntersect(Vec2f line1, Vec2f line2);
-vector<Point2f> lineToPointPair(Vec2f line);
-bool acceptLinePair(Vec2f line1, Vec2f line2, float minTheta);
-
 int main()
 {
     Mat occludedSquare = imread("F:\\abc.jpg");
@@ -39,21 +37,13 @@ int main()
     cout << "Detected " << lines.size() << " lines." << endl;
 
     // compute the intersection from the lines detected...
-    vector<Point2f> intersections;
-    for( size_t i = 0; i < lines.size(); i++ )
-    {
-        for(size_t j = 0; j < lines.size(); j++)
-        {
-            Vec2f line1 = lines[i];
-            Vec2f line2 = lines[j];
-            if(acceptLinePair(line1, line2, CV_PI / 32))
-            {
-                Point2f intersection = computeIntersect(line1, line2);
-                intersections.push_back(intersection);
-            }
-        }
+    // then merge those of nearly the same lines into one point
+    PC::OpenCV::LineIntersections lineIntersections;
+    vector<Point2f> points;
+    lineIntersections.intersect(lines, CV_PI / 32, points);
 
-    }
+    vector<Point2f> intersections;
+    lineIntersections.cluster(points, 2.0f, intersections);
 
     if(intersections.size() > 0)
     {
@@ -70,50 +60,3 @@ int main()
 
     return 0;
 }
-
-bool acceptLinePair(Vec2f line1, Vec2f line2, float minTheta)
-{
-    float theta1 = line1[1], theta2 = line2[1];
-
-    if(theta1 < minTheta)
-    {
-        theta1 += CV_PI; // dealing with 0 and 180 ambiguities...
-    }
-
-    if(theta2 < minTheta)
-    {
-        theta2 += CV_PI; // dealing with 0 and 180 ambiguities...
-    }
-
-    return abs(theta1 - theta2) > minTheta;
-}
-
-// the long nasty wikipedia line-intersection equation...bleh...
-Point2f computeIntersect(Vec2f line1, Vec2f line2)
-{
-    vector<Point2f> p1 = lineToPointPair(line1);
-    vector<Point2f> p2 = lineToPointPair(line2);
-
-    float denom = (p1[0].x - p1[1].x)*(p2[0].y - p2[1].y) - (p1[0].y - p1[1].y)*(p2[0].x - p2[1].x);
-    Point2f intersect(((p1[0].x*p1[1].y - p1[0].y*p1[1].x)*(p2[0].x - p2[1].x) -
-                       (p1[0].x - p1[1].x)*(p2[0].x*p2[1].y - p2[0].y*p2[1].x)) / denom,
-                      ((p1[0].x*p1[1].y - p1[0].y*p1[1].x)*(p2[0].y - p2[1].y) -
-                       (p1[0].y - p1[1].y)*(p2[0].x*p2[1].y - p2[0].y*p2[1].x)) / denom);
-
-    return intersect;
-}
-
-vector<Point2f> lineToPointPair(Vec2f line)
-{
-    vector<Point2f> points;
-
-    float r = line[0], t = line[1];
-    auto cos_t = cos(t), sin_t = sin(t);
-    auto x0 = r*cos_t, y0 = r*sin_t;
-    float alpha = 1000;
-
-    points.push_back(Point2f(x0 + alpha*(-sin_t), y0 + alpha*cos_t));
-    points.push_back(Point2f(x0 - alpha*(-sin_t), y0 - alpha*cos_t));
-
-    return points;
-}